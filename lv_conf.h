@@ -25,8 +25,11 @@
    COLOR SETTINGS
  *====================*/
 
-/** Color depth: 1 (I1), 8 (L8), 16 (RGB565), 24 (RGB888), 32 (XRGB8888) */
-#define LV_COLOR_DEPTH 32
+/** Color depth: 1 (I1), 8 (L8), 16 (RGB565), 24 (RGB888), 32 (XRGB8888)
+ *  The LV_DEVICE_PROFILE CMake option overrides it with 16. */
+#ifndef LV_COLOR_DEPTH
+    #define LV_COLOR_DEPTH 32
+#endif
 
 /*=========================
    STDLIB WRAPPER SETTINGS
@@ -105,8 +108,11 @@
  * - LV_OS_WINDOWS
  * - LV_OS_MQX
  * - LV_OS_SDL2
- * - LV_OS_CUSTOM */
-#define LV_USE_OS   LV_OS_NONE
+ * - LV_OS_CUSTOM
+ * The LV_MT_RENDER CMake option overrides it with LV_OS_PTHREAD. */
+#ifndef LV_USE_OS
+    #define LV_USE_OS   LV_OS_NONE
+#endif
 
 #if LV_USE_OS == LV_OS_CUSTOM
     #define LV_OS_CUSTOM_INCLUDE <stdint.h>
@@ -141,8 +147,11 @@
  * "Transformed layers" (if `transform_angle/zoom` are set) use larger buffers
  * and can't be drawn in chunks. */
 
-/** The target buffer size for simple layer chunks. */
-#define LV_DRAW_LAYER_SIMPLE_BUF_SIZE    (24 * 1024)    /**< [bytes]*/
+/** The target buffer size for simple layer chunks.
+ *  The LV_DEVICE_PROFILE CMake option overrides it with LV_DEVICE_LAYER_BUF_KB. */
+#ifndef LV_DRAW_LAYER_SIMPLE_BUF_SIZE
+    #define LV_DRAW_LAYER_SIMPLE_BUF_SIZE    (24 * 1024)    /**< [bytes]*/
+#endif
 
 /* Limit the max allocated memory for simple and transformed layers.
  * It should be at least `LV_DRAW_LAYER_SIMPLE_BUF_SIZE` sized but if transformed layers are also used
@@ -153,7 +162,9 @@
 /** Stack size of drawing thread.
  * NOTE: If FreeType or ThorVG is enabled, it is recommended to set it to 32KB or more.
  */
-#define LV_DRAW_THREAD_STACK_SIZE    (8 * 1024)         /**< [bytes]*/
+#ifndef LV_DRAW_THREAD_STACK_SIZE
+    #define LV_DRAW_THREAD_STACK_SIZE    (8 * 1024)         /**< [bytes]*/
+#endif
 
 #define LV_USE_DRAW_SW 1
 #if LV_USE_DRAW_SW == 1
@@ -180,8 +191,11 @@
 
     /** Set number of draw units.
      *  - > 1 requires operating system to be enabled in `LV_USE_OS`.
-     *  - > 1 means multiple threads will render the screen in parallel. */
-    #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+     *  - > 1 means multiple threads will render the screen in parallel.
+     *  Set by LV_MT_RENDER_UNITS when the LV_MT_RENDER CMake option is on. */
+    #ifndef LV_DRAW_SW_DRAW_UNIT_CNT
+        #define LV_DRAW_SW_DRAW_UNIT_CNT    1
+    #endif
 
     /** Use Arm-2D to accelerate software (sw) rendering. */
     #define LV_USE_DRAW_ARM2D_SYNC      0
@@ -207,10 +221,11 @@
         #define LV_DRAW_SW_CIRCLE_CACHE_SIZE 4
     #endif
 
-    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_NONE
+    #define  LV_USE_DRAW_SW_ASM     LV_DRAW_SW_ASM_CUSTOM
 
     #if LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM
-        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE ""
+        /*SSE4.1/AVX2 kernels selected at runtime; fall back to the C code on other CPUs*/
+        #define  LV_DRAW_SW_ASM_CUSTOM_INCLUDE "main/src/lv_draw_sw_simd.h"
     #endif
 
     /** Enable drawing complex gradients in software: linear at an angle, radial or conical */
@@ -1017,31 +1032,41 @@
     #endif
 #endif /*LV_USE_SYSMON*/
 
-/** 1: Enable runtime performance profiler */
-#define LV_USE_PROFILER 0
+/** 1: Enable runtime performance profiler
+ *  Only in builds configured with -DLV_TRACE=ON: every profiler point is an out-of-line call */
+#if defined(LV_TRACE) && LV_TRACE
+    #define LV_USE_PROFILER 1
+#else
+    #define LV_USE_PROFILER 0
+#endif
 #if LV_USE_PROFILER
     /** 1: Enable the built-in profiler */
-    #define LV_USE_PROFILER_BUILTIN 1
+    #define LV_USE_PROFILER_BUILTIN 0
     #if LV_USE_PROFILER_BUILTIN
         /** Default profiler trace buffer size */
         #define LV_PROFILER_BUILTIN_BUF_SIZE (16 * 1024)     /**< [bytes] */
         #define LV_PROFILER_BUILTIN_DEFAULT_ENABLE 1
     #endif
 
-    /** Header to include for profiler */
-    #define LV_PROFILER_INCLUDE "lvgl/src/misc/lv_profiler_builtin.h"
+    /** Header to include for profiler.
+     *  The app's trace writer (main/ui/system/trace.h) records the spans and exports Chrome trace JSON.
+     *  It is a no-op until trace_start() is called. */
+    #define LV_PROFILER_INCLUDE "main/ui/system/trace.h"
 
     /** Profiler start point function */
-    #define LV_PROFILER_BEGIN    LV_PROFILER_BUILTIN_BEGIN
+    #define LV_PROFILER_BEGIN    trace_begin(__func__)
 
     /** Profiler end point function */
-    #define LV_PROFILER_END      LV_PROFILER_BUILTIN_END
+    #define LV_PROFILER_END      trace_end(__func__)
 
     /** Profiler start point function with custom tag */
-    #define LV_PROFILER_BEGIN_TAG LV_PROFILER_BUILTIN_BEGIN_TAG
+    #define LV_PROFILER_BEGIN_TAG(tag) trace_begin(tag)
 
     /** Profiler end point function with custom tag */
-    #define LV_PROFILER_END_TAG   LV_PROFILER_BUILTIN_END_TAG
+    #define LV_PROFILER_END_TAG(tag)   trace_end(tag)
+
+    /*Event, cache and draw points run for every event dispatch, cache lookup and draw task:
+     *only with -DLV_TRACE_HOT=ON*/
 
     /*Enable layout profiler*/
     #define LV_PROFILER_LAYOUT 1
@@ -1050,7 +1075,11 @@
     #define LV_PROFILER_REFR 1
 
     /*Enable draw profiler*/
-    #define LV_PROFILER_DRAW 1
+    #if defined(LV_TRACE_HOT) && LV_TRACE_HOT
+        #define LV_PROFILER_DRAW 1
+    #else
+        #define LV_PROFILER_DRAW 0
+    #endif
 
     /*Enable indev profiler*/
     #define LV_PROFILER_INDEV 1
@@ -1071,10 +1100,18 @@
     #define LV_PROFILER_TIMER 1
 
     /*Enable cache profiler*/
-    #define LV_PROFILER_CACHE 1
+    #if defined(LV_TRACE_HOT) && LV_TRACE_HOT
+        #define LV_PROFILER_CACHE 1
+    #else
+        #define LV_PROFILER_CACHE 0
+    #endif
 
     /*Enable event profiler*/
-    #define LV_PROFILER_EVENT 1
+    #if defined(LV_TRACE_HOT) && LV_TRACE_HOT
+        #define LV_PROFILER_EVENT 1
+    #else
+        #define LV_PROFILER_EVENT 0
+    #endif
 #endif
 
 /** 1: Enable Monkey test */
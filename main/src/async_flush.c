@@ -0,0 +1,309 @@
+/**
+ * @file async_flush.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "async_flush.h"
+#include "lcd_bus.h"
+#include "lv_draw_sw_simd.h"
+#include "lvgl/src/display/lv_display_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if LV_USE_SDL
+  #include LV_SDL_INCLUDE_PATH
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_BUF_DIVISOR     10
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*The area being pushed; with two draw buffers there is at most one*/
+typedef struct {
+    lv_area_t area;
+    uint8_t * px_map;
+    bool last;
+} job_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_USE_SDL
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+static void flush_wait_cb(lv_display_t * disp);
+static int SDLCALL flush_thread_cb(void * data);
+static void copy_area(const job_t * job);
+static uint64_t now_us(void);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_display_t * flush_disp;
+static lv_display_flush_cb_t driver_flush_cb;
+static void (*notify_cb)(void);
+static bool swap_bytes;
+
+static uint8_t * draw_bufs[2];
+/*Frame assembled by the flush thread, shown by the driver*/
+static uint8_t * frame;
+static uint32_t frame_stride;
+static uint32_t px_size;
+
+#if LV_USE_SDL
+static SDL_mutex * mutex;
+static SDL_cond * cond;
+static SDL_Thread * thread;
+#endif
+
+/*Protected by `mutex`*/
+static job_t job;
+static bool job_pending;
+static bool present_pending;
+static async_flush_stats_t stats;
+static uint64_t stats_start_us;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+bool async_flush_init(lv_display_t * disp, const async_flush_config_t * cfg)
+{
+#if LV_USE_SDL
+    uint32_t divisor = cfg->buf_divisor ? cfg->buf_divisor : DEFAULT_BUF_DIVISOR;
+    int32_t hor_res = lv_display_get_horizontal_resolution(disp);
+    int32_t ver_res = lv_display_get_vertical_resolution(disp);
+    lv_color_format_t cf = lv_display_get_color_format(disp);
+
+    px_size = lv_color_format_get_size(cf);
+    frame_stride = lv_draw_buf_width_to_stride(hor_res, cf);
+    uint32_t lines = (ver_res + divisor - 1) / divisor;
+    uint32_t buf_size = frame_stride * lines;
+
+    draw_bufs[0] = malloc(buf_size);
+    draw_bufs[1] = malloc(buf_size);
+    frame = calloc(ver_res, frame_stride);
+    mutex = SDL_CreateMutex();
+    cond = SDL_CreateCond();
+    if(draw_bufs[0] == NULL || draw_bufs[1] == NULL || frame == NULL || mutex == NULL || cond == NULL) {
+        fprintf(stderr, "Async flush: out of memory\n");
+        return false;
+    }
+
+    flush_disp = disp;
+    notify_cb = cfg->notify_cb;
+    swap_bytes = cfg->swap_bytes && cf == LV_COLOR_FORMAT_RGB565;
+    if(cfg->swap_bytes && !swap_bytes) printf("Async flush: byte swap ignored, the display is not RGB565\n");
+    driver_flush_cb = disp->flush_cb;
+    lv_display_set_buffers(disp, draw_bufs[0], draw_bufs[1], buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_set_flush_wait_cb(disp, flush_wait_cb);
+    async_flush_reset_stats();
+
+    thread = SDL_CreateThread(flush_thread_cb, "async_flush", NULL);
+    if(thread == NULL) {
+        fprintf(stderr, "Async flush: can't create the thread: %s\n", SDL_GetError());
+        flush_disp = NULL;
+        return false;
+    }
+
+    printf("Async flush: 2 x %.1f KB draw buffers (%u lines, 1/%u screen)%s\n",
+           buf_size / 1024.0, (unsigned)lines, (unsigned)divisor, swap_bytes ? ", RGB565 byte swap" : "");
+    return true;
+#else
+    LV_UNUSED(disp);
+    LV_UNUSED(cfg);
+    fprintf(stderr, "Async flush needs the SDL thread API\n");
+    return false;
+#endif
+}
+
+bool async_flush_enabled(void)
+{
+    return flush_disp != NULL;
+}
+
+void async_flush_present(void)
+{
+#if LV_USE_SDL
+    if(flush_disp == NULL) return;
+
+    SDL_LockMutex(mutex);
+    if(present_pending) {
+        present_pending = false;
+        lv_area_t full;
+        lv_area_set(&full, 0, 0, lv_display_get_horizontal_resolution(flush_disp) - 1,
+                    lv_display_get_vertical_resolution(flush_disp) - 1);
+
+        /*The driver sees a whole frame as the last area; its flush_ready must not
+         *release the draw buffer the flush thread may be pushing right now*/
+        int32_t flushing = flush_disp->flushing;
+        int32_t flushing_last = flush_disp->flushing_last;
+        flush_disp->flushing_last = 1;
+        driver_flush_cb(flush_disp, &full, frame);
+        flush_disp->flushing = flushing;
+        flush_disp->flushing_last = flushing_last;
+    }
+    SDL_UnlockMutex(mutex);
+#endif
+}
+
+void async_flush_sync(void)
+{
+#if LV_USE_SDL
+    if(flush_disp == NULL) return;
+
+    SDL_LockMutex(mutex);
+    while(job_pending) SDL_CondWait(cond, mutex);
+    SDL_UnlockMutex(mutex);
+    async_flush_present();
+#endif
+}
+
+void async_flush_get_stats(async_flush_stats_t * out)
+{
+#if LV_USE_SDL
+    if(mutex) SDL_LockMutex(mutex);
+    *out = stats;
+    out->overlap_us = stats.push_us > stats.wait_us ? stats.push_us - stats.wait_us : 0;
+    out->wall_us = now_us() - stats_start_us;
+    if(mutex) SDL_UnlockMutex(mutex);
+#else
+    memset(out, 0, sizeof(*out));
+#endif
+}
+
+void async_flush_reset_stats(void)
+{
+#if LV_USE_SDL
+    if(mutex) SDL_LockMutex(mutex);
+    memset(&stats, 0, sizeof(stats));
+    stats_start_us = now_us();
+    if(mutex) SDL_UnlockMutex(mutex);
+#endif
+}
+
+void async_flush_log_stats(void)
+{
+    if(flush_disp == NULL) return;
+
+    async_flush_stats_t s;
+    async_flush_get_stats(&s);
+    if(s.frames == 0 || s.wall_us == 0) {
+        printf("Async flush: no frames\n");
+    }
+    else {
+        printf("Async flush: %.1f frames/s, %.1f flushes/frame, push %.2f ms/frame, "
+               "render waited %.2f ms/frame, overlap %.1f%%\n",
+               s.frames * 1000000.0 / s.wall_us, (double)s.flushes / s.frames,
+               s.push_us / 1000.0 / s.frames, s.wait_us / 1000.0 / s.frames,
+               s.push_us ? s.overlap_us * 100.0 / s.push_us : 0.0);
+    }
+    async_flush_reset_stats();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_USE_SDL
+
+/*Hand the area to the flush thread and return; LVGL continues in the other buffer*/
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    /*On the render thread, as on the device; the draw buffer has no stride padding in RGB565*/
+    if(swap_bytes) lv_draw_sw_simd_rgb565_swap(px_map, lv_area_get_size(area));
+
+    SDL_LockMutex(mutex);
+    /*LVGL has waited for the other buffer, so the thread is normally idle here*/
+    while(job_pending) SDL_CondWait(cond, mutex);
+    job.area = *area;
+    job.px_map = px_map;
+    job.last = lv_display_flush_is_last(disp);
+    job_pending = true;
+    SDL_CondBroadcast(cond);
+    SDL_UnlockMutex(mutex);
+}
+
+/*LVGL needs the buffer that is being pushed: block until the thread releases it*/
+static void flush_wait_cb(lv_display_t * disp)
+{
+    LV_UNUSED(disp);
+    SDL_LockMutex(mutex);
+    if(job_pending) {
+        uint64_t start = now_us();
+        while(job_pending) SDL_CondWait(cond, mutex);
+        stats.wait_us += now_us() - start;
+    }
+    SDL_UnlockMutex(mutex);
+}
+
+static int SDLCALL flush_thread_cb(void * data)
+{
+    LV_UNUSED(data);
+
+    SDL_LockMutex(mutex);
+    while(1) {
+        while(!job_pending) SDL_CondWait(cond, mutex);
+        job_t cur = job;
+        SDL_UnlockMutex(mutex);
+
+        uint64_t start = now_us();
+        copy_area(&cur);
+        lcd_bus_push(lv_area_get_size(&cur.area), cur.last);
+        uint64_t push_us = now_us() - start;
+
+        SDL_LockMutex(mutex);
+        stats.flushes++;
+        stats.push_us += push_us;
+        if(cur.last) {
+            stats.frames++;
+            present_pending = true;
+        }
+        job_pending = false;
+        /*Like the DMA-complete interrupt*/
+        lv_display_flush_ready(flush_disp);
+        SDL_CondBroadcast(cond);
+
+        if(cur.last && notify_cb) {
+            SDL_UnlockMutex(mutex);
+            notify_cb();
+            SDL_LockMutex(mutex);
+        }
+    }
+    return 0;
+}
+
+static void copy_area(const job_t * j)
+{
+    int32_t w = lv_area_get_width(&j->area);
+    int32_t h = lv_area_get_height(&j->area);
+    uint32_t src_stride = lv_draw_buf_width_to_stride(w, lv_display_get_color_format(flush_disp));
+    const uint8_t * src = j->px_map;
+    uint8_t * dest = frame + j->area.y1 * frame_stride + j->area.x1 * px_size;
+
+    for(int32_t y = 0; y < h; y++) {
+        memcpy(dest, src, (size_t)w * px_size);
+        if(swap_bytes) lv_draw_sw_simd_rgb565_swap(dest, (uint32_t)w);
+        src += src_stride;
+        dest += frame_stride;
+    }
+}
+
+static uint64_t now_us(void)
+{
+    /*Split to avoid overflowing 64 bits with nanosecond counters*/
+    uint64_t cnt = SDL_GetPerformanceCounter();
+    uint64_t freq = SDL_GetPerformanceFrequency();
+    return cnt / freq * 1000000u + cnt % freq * 1000000u / freq;
+}
+
+#endif /*LV_USE_SDL*/
@@ -0,0 +1,84 @@
+/**
+ * @file async_flush.h
+ * Double-buffered partial rendering with the flush on a dedicated thread,
+ * the way the device drives the panel with DMA.
+ *
+ * The display gets two partial draw buffers (a fraction of the screen each).
+ * The flush callback hands the rendered area to the flush thread and returns,
+ * so LVGL renders the next area into the other buffer while the first one is
+ * pushed. The flush thread copies the area into a frame buffer (paced by the
+ * LCD bus model if it is configured, see lcd_bus.h) and then releases the draw
+ * buffer with lv_display_flush_ready(), like a DMA-complete interrupt.
+ * Finished frames are shown by the display driver from the main thread
+ * (`async_flush_present`), as SDL must not be called from other threads.
+ *
+ * With `swap_bytes` the flush callback swaps the RGB565 bytes of the area in
+ * place, as the device does for big-endian SPI panels, and the flush thread
+ * swaps them back into the frame like the panel's decoder.
+ */
+
+#ifndef ASYNC_FLUSH_H
+#define ASYNC_FLUSH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t buf_divisor;       /*Each draw buffer holds 1/buf_divisor of the screen (default 10)*/
+    void (*notify_cb)(void);    /*Called on the flush thread when a frame is ready to be presented*/
+    bool swap_bytes;            /*RGB565 only: swap the bytes for an SPI panel before the push*/
+} async_flush_config_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t flushes;
+    uint64_t push_us;           /*Time the flush thread spent pushing areas*/
+    uint64_t wait_us;           /*Time LVGL waited for a free draw buffer*/
+    uint64_t overlap_us;        /*Push time hidden behind rendering: push_us - wait_us*/
+    uint64_t wall_us;           /*Time since the last reset*/
+} async_flush_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Switch the display to double-buffered partial rendering with the flush thread.
+ * Call it after the display driver has set its flush callback (and after
+ * `lcd_bus_configure` to pace the pushes). Only one display is supported.
+ * @return  false if the buffers or the thread can't be created
+ */
+bool async_flush_init(lv_display_t * disp, const async_flush_config_t * cfg);
+
+bool async_flush_enabled(void);
+
+/** Show the last finished frame with the display driver. Call it from the main thread. */
+void async_flush_present(void);
+
+/** Wait until the flush thread is idle, then present */
+void async_flush_sync(void);
+
+void async_flush_get_stats(async_flush_stats_t * stats);
+
+void async_flush_reset_stats(void);
+
+/** Print the frame rate, push time and render/flush overlap since the last call, then reset */
+void async_flush_log_stats(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*ASYNC_FLUSH_H*/
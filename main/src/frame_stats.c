@@ -0,0 +1,250 @@
+/**
+ * @file frame_stats.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifndef _DEFAULT_SOURCE
+  #define _DEFAULT_SOURCE
+#endif
+
+#include "frame_stats.h"
+#include "lvgl/src/display/lv_display_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <time.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FRAME_STATS_MASK        (FRAME_STATS_CAPACITY - 1)
+
+#if defined(__GNUC__) || defined(__clang__)
+  #define ATOMIC_LOAD(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+  #define ATOMIC_STORE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+  #define ATOMIC_FENCE_ACQ()    __atomic_thread_fence(__ATOMIC_ACQUIRE)
+  #define ATOMIC_FENCE_REL()    __atomic_thread_fence(__ATOMIC_RELEASE)
+#else
+  /*x86/x64 MSVC: plain volatile accesses are ordered, only stop the compiler*/
+  #include <intrin.h>
+  #define ATOMIC_LOAD(p)        (_ReadWriteBarrier(), *(volatile uint32_t *)(p))
+  #define ATOMIC_STORE(p, v)    do { _ReadWriteBarrier(); *(volatile uint32_t *)(p) = (v); } while(0)
+  #define ATOMIC_FENCE_ACQ()    _ReadWriteBarrier()
+  #define ATOMIC_FENCE_REL()    _ReadWriteBarrier()
+#endif
+
+#if (FRAME_STATS_CAPACITY & FRAME_STATS_MASK) != 0
+  #error "FRAME_STATS_CAPACITY must be a power of two"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*Sequence lock per slot: odd while the main loop writes the record*/
+typedef struct {
+    uint32_t seq;
+    frame_stats_record_t rec;
+} slot_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint64_t now_us(void);
+static void display_event_cb(lv_event_t * e);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static slot_t slots[FRAME_STATS_CAPACITY];
+static uint32_t write_pos;              /*Records written; only the main loop modifies it*/
+
+static frame_stats_page_cb_t page_cb;
+static lv_display_t * stats_disp;
+
+/*State of the current loop iteration*/
+static uint64_t loop_start_us;
+static uint64_t render_start_us;
+static uint64_t flush_start_us;
+static uint32_t flush_at_render_start;
+static uint32_t cur_render_us;
+static uint32_t cur_flush_us;
+static uint32_t cur_area_px;
+static uint16_t cur_areas;
+static bool cur_rendered;
+
+static char dump_path[256];
+static volatile int dump_requested;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void frame_stats_init(lv_display_t * disp, frame_stats_page_cb_t cb)
+{
+    stats_disp = disp;
+    page_cb = cb;
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_RENDER_READY, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_FLUSH_FINISH, NULL);
+}
+
+void frame_stats_loop_begin(void)
+{
+    loop_start_us = now_us();
+    cur_render_us = 0;
+    cur_flush_us = 0;
+    cur_area_px = 0;
+    cur_areas = 0;
+    cur_rendered = false;
+}
+
+void frame_stats_loop_end(void)
+{
+    if(dump_requested) {
+        dump_requested = 0;
+        frame_stats_dump_csv(dump_path);
+    }
+    if(stats_disp == NULL || !cur_rendered) return;
+
+    uint32_t pos = write_pos;
+    slot_t * slot = &slots[pos & FRAME_STATS_MASK];
+
+    ATOMIC_STORE(&slot->seq, slot->seq + 1);
+    ATOMIC_FENCE_REL();
+
+    frame_stats_record_t * rec = &slot->rec;
+    rec->frame = pos;
+    rec->start_us = loop_start_us;
+    rec->handler_us = (uint32_t)(now_us() - loop_start_us);
+    rec->render_us = cur_render_us;
+    rec->flush_us = cur_flush_us;
+    rec->inv_area_px = cur_area_px;
+    rec->inv_areas = cur_areas;
+    const char * page = page_cb ? page_cb() : NULL;
+    lv_strlcpy(rec->page, page ? page : "", FRAME_STATS_NAME_LEN);
+
+    ATOMIC_STORE(&slot->seq, slot->seq + 1);
+    ATOMIC_STORE(&write_pos, pos + 1);
+}
+
+uint32_t frame_stats_snapshot(frame_stats_record_t * out)
+{
+    uint32_t end = ATOMIC_LOAD(&write_pos);
+    uint32_t begin = end > FRAME_STATS_CAPACITY ? end - FRAME_STATS_CAPACITY : 0;
+    uint32_t cnt = 0;
+
+    for(uint32_t i = begin; i < end; i++) {
+        slot_t * slot = &slots[i & FRAME_STATS_MASK];
+        uint32_t seq = ATOMIC_LOAD(&slot->seq);
+        if(seq & 1) continue;
+
+        memcpy(&out[cnt], &slot->rec, sizeof(frame_stats_record_t));
+        ATOMIC_FENCE_ACQ();
+        /*Overwritten by a newer frame while copying*/
+        if(ATOMIC_LOAD(&slot->seq) != seq || out[cnt].frame != i) continue;
+        cnt++;
+    }
+    return cnt;
+}
+
+int32_t frame_stats_dump_csv(const char * path)
+{
+    frame_stats_record_t * recs = malloc(sizeof(frame_stats_record_t) * FRAME_STATS_CAPACITY);
+    if(recs == NULL) return -1;
+
+    FILE * f = fopen(path, "w");
+    if(f == NULL) {
+        free(recs);
+        return -1;
+    }
+
+    uint32_t cnt = frame_stats_snapshot(recs);
+    fprintf(f, "frame,start_us,handler_us,render_us,flush_us,other_us,inv_areas,inv_area_px,page\n");
+    for(uint32_t i = 0; i < cnt; i++) {
+        const frame_stats_record_t * r = &recs[i];
+        uint32_t busy = r->render_us + r->flush_us;
+        fprintf(f, "%u,%llu,%u,%u,%u,%u,%u,%u,%s\n",
+                (unsigned)r->frame, (unsigned long long)r->start_us, (unsigned)r->handler_us,
+                (unsigned)r->render_us, (unsigned)r->flush_us,
+                (unsigned)(r->handler_us > busy ? r->handler_us - busy : 0),
+                (unsigned)r->inv_areas, (unsigned)r->inv_area_px, r->page);
+    }
+    fclose(f);
+    free(recs);
+    return (int32_t)cnt;
+}
+
+void frame_stats_request_dump(const char * path)
+{
+    if(!dump_requested) {
+        lv_strlcpy(dump_path, path, sizeof(dump_path));
+        dump_requested = 1;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint64_t now_us(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER cnt;
+    if(freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+    return (uint64_t)(cnt.QuadPart * 1000000 / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+#endif
+}
+
+static void display_event_cb(lv_event_t * e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    uint64_t now = now_us();
+
+    switch(code) {
+        case LV_EVENT_RENDER_START:
+            /*The invalidated areas are joined at this point*/
+            for(uint32_t i = 0; i < stats_disp->inv_p; i++) {
+                if(stats_disp->inv_area_joined[i]) continue;
+                cur_area_px += lv_area_get_size(&stats_disp->inv_areas[i]);
+                cur_areas++;
+            }
+            render_start_us = now;
+            flush_at_render_start = cur_flush_us;
+            cur_rendered = true;
+            break;
+        case LV_EVENT_RENDER_READY:
+            /*Flushes happen inside rendering; count them separately*/
+            if(render_start_us) {
+                uint32_t total = (uint32_t)(now - render_start_us);
+                uint32_t flushed = cur_flush_us - flush_at_render_start;
+                cur_render_us += total > flushed ? total - flushed : 0;
+                render_start_us = 0;
+            }
+            break;
+        case LV_EVENT_FLUSH_START:
+            flush_start_us = now;
+            break;
+        case LV_EVENT_FLUSH_FINISH:
+            if(flush_start_us) {
+                cur_flush_us += (uint32_t)(now - flush_start_us);
+                flush_start_us = 0;
+            }
+            break;
+        default:
+            break;
+    }
+}
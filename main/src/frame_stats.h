@@ -0,0 +1,92 @@
+/**
+ * @file frame_stats.h
+ * Per-frame timing recorder. Every main loop iteration that refreshed the display
+ * is stored in a fixed-size ring buffer: timer handler time, render time, flush
+ * time, invalidated area and the active page. The buffer can be read from another
+ * thread without locking and dumped to CSV at any time.
+ */
+
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Number of frames kept, must be a power of two*/
+#ifndef FRAME_STATS_CAPACITY
+  #define FRAME_STATS_CAPACITY  1024
+#endif
+
+#define FRAME_STATS_NAME_LEN    24
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t frame;                     /*Frame number since start*/
+    uint64_t start_us;                  /*Start of the timer handler call*/
+    uint32_t handler_us;                /*Whole `lv_timer_handler` call*/
+    uint32_t render_us;                 /*Rendering, without the flush*/
+    uint32_t flush_us;                  /*Flush callbacks*/
+    uint32_t inv_area_px;               /*Invalidated area after joining*/
+    uint16_t inv_areas;                 /*Number of invalidated areas*/
+    char page[FRAME_STATS_NAME_LEN];    /*Active page*/
+} frame_stats_record_t;
+
+/** Returns the name of the active page, or NULL */
+typedef const char * (*frame_stats_page_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start recording the frames of a display.
+ * @param disp      the display to hook
+ * @param page_cb   returns the active page name for each record, can be NULL
+ */
+void frame_stats_init(lv_display_t * disp, frame_stats_page_cb_t page_cb);
+
+/** Call right before `lv_timer_handler()` */
+void frame_stats_loop_begin(void);
+
+/** Call right after `lv_timer_handler()`; stores a record if a frame was rendered */
+void frame_stats_loop_end(void);
+
+/**
+ * Copy the recorded frames, oldest first. Safe to call from any thread;
+ * records overwritten while being copied are skipped.
+ * @param out   destination, at least `FRAME_STATS_CAPACITY` records
+ * @return      number of records copied
+ */
+uint32_t frame_stats_snapshot(frame_stats_record_t * out);
+
+/**
+ * Write the recorded frames to a CSV file.
+ * @return  number of records written, or -1 if the file can't be opened
+ */
+int32_t frame_stats_dump_csv(const char * path);
+
+/**
+ * Request a dump from a signal handler or another thread. The main loop writes
+ * the file in the next `frame_stats_loop_end`.
+ */
+void frame_stats_request_dump(const char * path);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*FRAME_STATS_H*/
@@ -0,0 +1,166 @@
+/**
+ * @file fs_list_check.cpp
+ * Self-check of the compact directory listing: builds a small directory tree
+ * in a temporary directory and lists and caches it the way page_sd_files does.
+ * Prints every failed check and returns non-zero if any failed.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "system/filesystem_service.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int failures;
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#define CHECK(cond) \
+    do { \
+        if(!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while(0)
+
+static void touch(const std::string & path)
+{
+    FILE * f = fopen(path.c_str(), "w");
+    if(f) fclose(f);
+}
+
+/*Read a directory into `list` in batches and merge them, like DirLoader and page_sd_files*/
+static esp_err_t load_batched(const char * path, fs_dir_list_t * list)
+{
+    dir_iterator_t it;
+    esp_err_t ret = fs_open_directory(path, &it);
+    if(ret != ESP_OK) return ret;
+
+    do {
+        fs_dir_list_t batch = {};
+        ret = fs_read_next_batch(&it, FS_LIST_SIZE, &batch, 2);
+        fs_dir_list_sort(&batch, SORT_BY_NAME_ASC);
+        fs_dir_list_merge(list, &batch, SORT_BY_NAME_ASC);
+        fs_dir_list_free(&batch);
+    } while(ret == ESP_OK);
+    fs_close_directory(&it);
+    return ret == ESP_ERR_NOT_FOUND ? ESP_OK : ret;
+}
+
+/*The full path of every entry must be in `dir`*/
+static void check_paths(const fs_dir_list_t * list, const std::string & dir)
+{
+    CHECK(strcmp(list->path, dir.c_str()) == 0);
+    for(uint32_t i = 0; i < list->count; i++) {
+        char full_path[MAX_PATH_LEN];
+        CHECK(fs_dir_list_full_path(list, i, full_path, sizeof(full_path)) == ESP_OK);
+        std::string expected = dir + "/" + fs_dir_list_name(list, i);
+        CHECK(expected == full_path);
+    }
+}
+
+/*Two directories listed one after the other into the same list*/
+static void check_list_reuse(const std::string & root)
+{
+    std::string sub = root + "/sub1";
+
+    fs_dir_list_t list = {};
+    CHECK(load_batched(root.c_str(), &list) == ESP_OK);
+    CHECK(list.count == 4);
+    check_paths(&list, root);
+    fs_dir_list_free(&list);
+
+    CHECK(load_batched(sub.c_str(), &list) == ESP_OK);
+    CHECK(list.count == 3);
+    check_paths(&list, sub);
+    fs_dir_list_free(&list);
+
+    CHECK(fs_list_directory_compact(root.c_str(), SORT_BY_NAME_ASC, 0, &list) == ESP_OK);
+    check_paths(&list, root);
+    fs_dir_list_free(&list);
+    CHECK(fs_list_directory_compact(sub.c_str(), SORT_BY_NAME_ASC, 0, &list) == ESP_OK);
+    check_paths(&list, sub);
+    fs_dir_list_free(&list);
+}
+
+/*Each directory is cached under its own path, a list can't be stored under another path*/
+static void check_cache_keys(const std::string & root)
+{
+    std::string sub = root + "/sub1";
+    fs_dir_cache_invalidate(NULL);
+
+    fs_dir_list_t list = {};
+    CHECK(load_batched(root.c_str(), &list) == ESP_OK);
+    CHECK(fs_dir_cache_store(root.c_str(), &list, SORT_BY_NAME_ASC, FS_LIST_SIZE) == ESP_OK);
+    fs_dir_list_free(&list);
+
+    CHECK(load_batched(sub.c_str(), &list) == ESP_OK);
+    CHECK(fs_dir_cache_store(root.c_str(), &list, SORT_BY_NAME_ASC, FS_LIST_SIZE) != ESP_OK);
+    CHECK(fs_dir_cache_store(sub.c_str(), &list, SORT_BY_NAME_ASC, FS_LIST_SIZE) == ESP_OK);
+    fs_dir_list_free(&list);
+
+    /*"Back to parent" must get the parent's entries*/
+    CHECK(fs_dir_cache_lookup(root.c_str(), SORT_BY_NAME_ASC, FS_LIST_SIZE, &list) == ESP_OK);
+    CHECK(list.count == 4);
+    check_paths(&list, root);
+    fs_dir_list_free(&list);
+
+    CHECK(fs_dir_cache_lookup(sub.c_str(), SORT_BY_NAME_ASC, FS_LIST_SIZE, &list) == ESP_OK);
+    CHECK(list.count == 3);
+    check_paths(&list, sub);
+    fs_dir_list_free(&list);
+
+    /*A changed directory is read again*/
+    sleep(1);
+    touch(sub + "/w");
+    CHECK(fs_dir_cache_lookup(sub.c_str(), SORT_BY_NAME_ASC, FS_LIST_SIZE, &list) == ESP_ERR_NOT_FOUND);
+    fs_dir_list_free(&list);
+
+    fs_dir_cache_stats_t stats;
+    fs_dir_cache_get_stats(&stats);
+    CHECK(stats.hits == 2);
+    CHECK(stats.stale == 1);
+    fs_dir_cache_invalidate(NULL);
+}
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(void)
+{
+    char tmpl[] = "/tmp/fs_list_check.XXXXXX";
+    if(!mkdtemp(tmpl)) {
+        perror("mkdtemp");
+        return 1;
+    }
+    std::string root = tmpl;
+    std::string sub = root + "/sub1";
+    fs_init();
+    mkdir(sub.c_str(), 0755);
+    touch(root + "/a");
+    touch(root + "/b");
+    touch(root + "/c");
+    touch(sub + "/x");
+    touch(sub + "/y");
+    touch(sub + "/z");
+
+    check_list_reuse(root);
+    check_cache_keys(root);
+
+    std::string cmd = "rm -rf '" + root + "'";
+    if(system(cmd.c_str()) != 0) fprintf(stderr, "Can't remove %s\n", root.c_str());
+
+    printf("fs_list_check: %s\n", failures ? "FAILED" : "ok");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file headless_display.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifndef _DEFAULT_SOURCE
+  #define _DEFAULT_SOURCE
+#endif
+
+#include "headless_display.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SCRIPT_MAX_CMDS     1024
+#define TAP_HOLD_MS         50
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    CMD_WAIT,
+    CMD_PRESS,
+    CMD_MOVE,
+    CMD_RELEASE,
+} script_cmd_type_t;
+
+typedef struct {
+    script_cmd_type_t type;
+    int32_t x;
+    int32_t y;
+    uint32_t ms;
+} script_cmd_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+static uint32_t tick_cb(void);
+static uint64_t now_us(void);
+static void input_read_cb(lv_indev_t * indev, lv_indev_data_t * data);
+static bool script_add(script_cmd_type_t type, int32_t x, int32_t y, uint32_t ms);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint8_t * framebuffer;
+static uint32_t fb_size;
+static int32_t fb_w;
+static int32_t fb_h;
+
+static uint32_t flush_fixed_us;
+static uint32_t flush_ns_per_px;
+static headless_display_stats_t stats;
+
+static bool tick_virtual;
+static uint32_t tick_virtual_ms;
+
+static script_cmd_t script[SCRIPT_MAX_CMDS];
+static uint32_t script_len;
+static uint32_t script_pos;
+static uint32_t wait_start;
+static uint32_t wait_ms;
+static bool waiting;
+static lv_point_t point;
+static lv_indev_state_t point_state = LV_INDEV_STATE_RELEASED;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_display_t * headless_display_create(int32_t w, int32_t h)
+{
+    lv_tick_set_cb(tick_cb);
+
+    lv_display_t * disp = lv_display_create(w, h);
+    if(disp == NULL) return NULL;
+
+    fb_w = w;
+    fb_h = h;
+    fb_size = lv_draw_buf_width_to_stride(w, lv_display_get_color_format(disp)) * h;
+    framebuffer = malloc(fb_size);
+    if(framebuffer == NULL) {
+        lv_display_delete(disp);
+        return NULL;
+    }
+    memset(framebuffer, 0, fb_size);
+
+    /*Render straight into the framebuffer, like the SDL backend's DIRECT mode*/
+    lv_display_set_buffers(disp, framebuffer, NULL, fb_size, LV_DISPLAY_RENDER_MODE_DIRECT);
+    lv_display_set_flush_cb(disp, flush_cb);
+
+    return disp;
+}
+
+void headless_display_set_flush_cost(uint32_t fixed_us, uint32_t ns_per_px)
+{
+    flush_fixed_us = fixed_us;
+    flush_ns_per_px = ns_per_px;
+}
+
+const uint8_t * headless_display_get_framebuffer(void)
+{
+    return framebuffer;
+}
+
+uint32_t headless_display_checksum(void)
+{
+    uint32_t hash = 2166136261u;
+    for(uint32_t i = 0; i < fb_size; i++) {
+        hash ^= framebuffer[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool headless_display_save_ppm(const char * path)
+{
+#if LV_COLOR_DEPTH == 32 || LV_COLOR_DEPTH == 16
+    FILE * f = fopen(path, "wb");
+    if(f == NULL) return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", (int)fb_w, (int)fb_h);
+    uint32_t stride = fb_size / fb_h;
+    for(int32_t y = 0; y < fb_h; y++) {
+        const uint8_t * row = framebuffer + y * stride;
+        for(int32_t x = 0; x < fb_w; x++) {
+#if LV_COLOR_DEPTH == 32
+            /*XRGB8888 is stored as B, G, R, X*/
+            uint8_t rgb[3] = {row[x * 4 + 2], row[x * 4 + 1], row[x * 4 + 0]};
+#else
+            /*RGB565, little endian; scale the channels to 8 bits*/
+            uint16_t c = (uint16_t)(row[x * 2] | (row[x * 2 + 1] << 8));
+            uint8_t rgb[3] = {(uint8_t)((c >> 11) * 255 / 31), (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                              (uint8_t)((c & 0x1F) * 255 / 31)
+                             };
+#endif
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    fclose(f);
+    return true;
+#else
+    LV_UNUSED(path);
+    return false;
+#endif
+}
+
+void headless_display_get_stats(headless_display_stats_t * out)
+{
+    *out = stats;
+}
+
+void headless_tick_set_virtual(bool en)
+{
+    tick_virtual = en;
+    tick_virtual_ms = (uint32_t)(now_us() / 1000);
+}
+
+void headless_tick_advance(uint32_t ms)
+{
+    tick_virtual_ms += ms;
+}
+
+lv_indev_t * headless_input_create(lv_display_t * disp)
+{
+    lv_indev_t * indev = lv_indev_create();
+    lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
+    lv_indev_set_read_cb(indev, input_read_cb);
+    lv_indev_set_display(indev, disp);
+    return indev;
+}
+
+bool headless_input_push(const char * line)
+{
+    char cmd[16];
+    int x = 0, y = 0;
+
+    while(*line == ' ' || *line == '\t') line++;
+    if(*line == '\0' || *line == '\n' || *line == '\r' || *line == '#') return true;
+    if(sscanf(line, "%15s", cmd) != 1) return false;
+
+    if(strcmp(cmd, "wait") == 0) {
+        unsigned ms;
+        if(sscanf(line, "%*s %u", &ms) != 1) return false;
+        return script_add(CMD_WAIT, 0, 0, ms);
+    }
+    if(strcmp(cmd, "release") == 0) {
+        return script_add(CMD_RELEASE, 0, 0, 0);
+    }
+    if(sscanf(line, "%*s %d %d", &x, &y) != 2) return false;
+    if(strcmp(cmd, "press") == 0) return script_add(CMD_PRESS, x, y, 0);
+    if(strcmp(cmd, "move") == 0) return script_add(CMD_MOVE, x, y, 0);
+    if(strcmp(cmd, "tap") == 0) {
+        return script_add(CMD_PRESS, x, y, 0) &&
+               script_add(CMD_WAIT, 0, 0, TAP_HOLD_MS) &&
+               script_add(CMD_RELEASE, 0, 0, 0) &&
+               script_add(CMD_WAIT, 0, 0, TAP_HOLD_MS);
+    }
+    return false;
+}
+
+int32_t headless_input_load_script(const char * path)
+{
+    FILE * f = fopen(path, "r");
+    if(f == NULL) return -1;
+
+    script_len = 0;
+    script_pos = 0;
+    waiting = false;
+
+    char line[128];
+    uint32_t line_no = 0;
+    while(fgets(line, sizeof(line), f)) {
+        line_no++;
+        if(!headless_input_push(line)) {
+            LV_LOG_WARN("%s:%u: invalid script line", path, (unsigned)line_no);
+        }
+    }
+    fclose(f);
+    return (int32_t)script_len;
+}
+
+bool headless_input_done(void)
+{
+    return script_pos >= script_len && !waiting;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    uint64_t start = now_us();
+
+    /*In DIRECT mode the pixels are already in the framebuffer. Partial buffers
+     *(e.g. set by async_flush) are copied.*/
+    if(px_map != framebuffer) {
+        lv_color_format_t cf = lv_display_get_color_format(disp);
+        uint32_t px_size = lv_color_format_get_size(cf);
+        int32_t w = lv_area_get_width(area);
+        uint32_t src_stride = lv_draw_buf_width_to_stride(w, cf);
+        uint32_t fb_stride = fb_size / fb_h;
+        for(int32_t y = area->y1; y <= area->y2; y++) {
+            memcpy(framebuffer + y * fb_stride + area->x1 * px_size, px_map, (size_t)w * px_size);
+            px_map += src_stride;
+        }
+    }
+
+    /*Emulate the transfer cost*/
+    uint32_t px = lv_area_get_size(area);
+    uint64_t cost_us = flush_fixed_us + ((uint64_t)px * flush_ns_per_px) / 1000;
+    while(now_us() - start < cost_us) {
+        /*Busy wait like a blocking SPI transfer*/
+    }
+
+    stats.flush_count++;
+    stats.flushed_px += px;
+    stats.flush_time_us += now_us() - start;
+
+    lv_display_flush_ready(disp);
+}
+
+static uint64_t now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
+
+static uint32_t tick_cb(void)
+{
+    if(tick_virtual) return tick_virtual_ms;
+    return (uint32_t)(now_us() / 1000);
+}
+
+static bool script_add(script_cmd_type_t type, int32_t x, int32_t y, uint32_t ms)
+{
+    if(script_len >= SCRIPT_MAX_CMDS) return false;
+    script[script_len].type = type;
+    script[script_len].x = x;
+    script[script_len].y = y;
+    script[script_len].ms = ms;
+    script_len++;
+    return true;
+}
+
+/*Execute commands until a wait is reached; one state is reported per read*/
+static void input_read_cb(lv_indev_t * indev, lv_indev_data_t * data)
+{
+    LV_UNUSED(indev);
+    if(waiting && lv_tick_elaps(wait_start) >= wait_ms) waiting = false;
+
+    while(!waiting && script_pos < script_len) {
+        const script_cmd_t * cmd = &script[script_pos++];
+        bool report = false;
+        switch(cmd->type) {
+            case CMD_WAIT:
+                wait_start = lv_tick_get();
+                wait_ms = cmd->ms;
+                waiting = true;
+                break;
+            case CMD_PRESS:
+                point.x = cmd->x;
+                point.y = cmd->y;
+                point_state = LV_INDEV_STATE_PRESSED;
+                report = true;
+                break;
+            case CMD_MOVE:
+                point.x = cmd->x;
+                point.y = cmd->y;
+                report = true;
+                break;
+            case CMD_RELEASE:
+                point_state = LV_INDEV_STATE_RELEASED;
+                report = true;
+                break;
+        }
+        /*Let LVGL see every state change separately*/
+        if(report) break;
+    }
+
+    data->point = point;
+    data->state = point_state;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file headless_display.h
+ * Headless display backend: renders into an in-memory framebuffer and reads
+ * pointer input from a script, so the UI can run without SDL or a window.
+ */
+
+#ifndef HEADLESS_DISPLAY_H
+#define HEADLESS_DISPLAY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t flush_count;       /*Number of flush callbacks*/
+    uint64_t flushed_px;        /*Total pixels flushed*/
+    uint64_t flush_time_us;     /*Total time spent in the flush callback (including emulated cost)*/
+} headless_display_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create a display that renders into an internal framebuffer.
+ * Also installs the tick source (see `headless_tick_set_virtual`).
+ * @param w     horizontal resolution
+ * @param h     vertical resolution
+ * @return      the created display or NULL on allocation failure
+ */
+lv_display_t * headless_display_create(int32_t w, int32_t h);
+
+/**
+ * Emulate the cost of sending pixels to a panel. The flush callback busy-waits
+ * `fixed_us + flushed_px * ns_per_px / 1000` microseconds.
+ */
+void headless_display_set_flush_cost(uint32_t fixed_us, uint32_t ns_per_px);
+
+/** Framebuffer in the display's color format (LV_COLOR_DEPTH) */
+const uint8_t * headless_display_get_framebuffer(void);
+
+/** FNV-1a hash of the framebuffer, for regression comparisons */
+uint32_t headless_display_checksum(void);
+
+/**
+ * Write the framebuffer as a binary PPM image (32 bit color depth only).
+ * @return  true on success
+ */
+bool headless_display_save_ppm(const char * path);
+
+void headless_display_get_stats(headless_display_stats_t * stats);
+
+/**
+ * Use a virtual clock instead of the monotonic clock. The clock only moves
+ * when `headless_tick_advance` is called, so runs are deterministic and
+ * never sleep.
+ */
+void headless_tick_set_virtual(bool en);
+void headless_tick_advance(uint32_t ms);
+
+/**
+ * Create a pointer input device driven by a script.
+ * Script commands, one per line (`#` starts a comment):
+ *   wait <ms>          keep the current state for <ms>
+ *   press <x> <y>      press at a point
+ *   move <x> <y>       move while keeping the current state
+ *   release            release at the current point
+ *   tap <x> <y>        press, hold 50 ms, release, wait 50 ms
+ */
+lv_indev_t * headless_input_create(lv_display_t * disp);
+
+/**
+ * Load a script file. Replaces the pending commands.
+ * @return  number of commands loaded, or -1 if the file can't be opened
+ */
+int32_t headless_input_load_script(const char * path);
+
+/** Append a single script line, e.g. "tap 120 160" */
+bool headless_input_push(const char * line);
+
+/** True when all script commands have been played */
+bool headless_input_done(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*HEADLESS_DISPLAY_H*/
@@ -0,0 +1,346 @@
+/**
+ * @file inv_stats.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "inv_stats.h"
+#include "lvgl/src/display/lv_display_private.h"
+#include "lvgl/src/core/lv_obj_class_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define OTHER_IDX               INV_STATS_MAX_WIDGETS
+#define REPORT_TOP              10
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint16_t widget;
+    lv_area_t area;
+} frame_area_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void display_event_cb(lv_event_t * e);
+static void on_invalidate(const lv_area_t * area);
+static void on_render_start(void);
+static void tint_area(const lv_area_t * area);
+static lv_obj_t * find_owner(lv_obj_t * obj, const lv_area_t * area);
+static lv_obj_t * attribute(const lv_area_t * area);
+static uint16_t widget_index(lv_obj_t * obj);
+static int widget_cmp(const void * a, const void * b);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_display_t * stats_disp;
+static inv_stats_page_cb_t page_cb;
+static bool overlay;
+static FILE * log_file;
+
+/*Entry OTHER_IDX collects the widgets that don't fit*/
+static inv_stats_widget_t widgets[INV_STATS_MAX_WIDGETS + 1];
+static uint32_t widget_cnt;
+static inv_stats_t stats;
+static uint32_t stats_start_ms;
+
+/*Areas invalidated since the last rendered frame*/
+static frame_area_t frame_areas[INV_STATS_MAX_FRAME_AREAS];
+static uint32_t frame_area_cnt;
+static uint32_t frame_no;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void inv_stats_init(lv_display_t * disp, inv_stats_page_cb_t cb)
+{
+    stats_disp = disp;
+    page_cb = cb;
+    inv_stats_reset();
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_FLUSH_START, NULL);
+}
+
+void inv_stats_set_overlay(bool en)
+{
+    overlay = en;
+    /*Start from a clean screen when the overlay is turned off*/
+    if(!en && stats_disp) lv_obj_invalidate(lv_display_get_screen_active(stats_disp));
+}
+
+bool inv_stats_open_log(const char * path)
+{
+    inv_stats_close_log();
+    log_file = fopen(path, "w");
+    if(log_file == NULL) return false;
+    fprintf(log_file, "frame,time_ms,widget,x1,y1,x2,y2\n");
+    return true;
+}
+
+void inv_stats_close_log(void)
+{
+    if(log_file == NULL) return;
+    fclose(log_file);
+    log_file = NULL;
+}
+
+void inv_stats_get(inv_stats_t * out)
+{
+    *out = stats;
+    out->wall_ms = lv_tick_elaps(stats_start_ms);
+}
+
+uint32_t inv_stats_get_widgets(inv_stats_widget_t * out)
+{
+    uint32_t cnt = 0;
+    for(uint32_t i = 0; i < widget_cnt; i++) out[cnt++] = widgets[i];
+    if(widgets[OTHER_IDX].areas) out[cnt++] = widgets[OTHER_IDX];
+    qsort(out, cnt, sizeof(inv_stats_widget_t), widget_cmp);
+    return cnt;
+}
+
+void inv_stats_reset(void)
+{
+    memset(widgets, 0, sizeof(widgets));
+    lv_strlcpy(widgets[OTHER_IDX].name, "(other)", INV_STATS_NAME_LEN);
+    widget_cnt = 0;
+    /*The areas of the pending frame refer to the cleared widgets*/
+    frame_area_cnt = 0;
+    memset(&stats, 0, sizeof(stats));
+    stats_start_ms = lv_tick_get();
+}
+
+void inv_stats_log_report(void)
+{
+    if(stats_disp == NULL) return;
+
+    inv_stats_t s;
+    inv_stats_get(&s);
+    if(s.frames == 0 || s.wall_ms == 0) {
+        printf("Invalidation: no frames\n");
+        inv_stats_reset();
+        return;
+    }
+
+    double sec = s.wall_ms / 1000.0;
+    printf("Invalidation: %.1f frames/s, %.1f areas/frame, invalidated %.1f Kpx/s, redrawn %.1f Kpx/s\n",
+           s.frames / sec, (double)s.areas / s.frames, s.inv_px / 1000.0 / sec, s.redrawn_px / 1000.0 / sec);
+
+    inv_stats_widget_t * list = malloc(sizeof(inv_stats_widget_t) * (INV_STATS_MAX_WIDGETS + 1));
+    if(list) {
+        uint32_t cnt = inv_stats_get_widgets(list);
+        printf("  %10s %8s %6s  %s\n", "px/s", "inv/s", "share", "widget");
+        for(uint32_t i = 0; i < cnt && i < REPORT_TOP; i++) {
+            printf("  %10.0f %8.1f %5.1f%%  %s\n", list[i].px / sec, list[i].areas / sec,
+                   s.inv_px ? list[i].px * 100.0 / s.inv_px : 0.0, list[i].name);
+        }
+        free(list);
+    }
+    inv_stats_reset();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void display_event_cb(lv_event_t * e)
+{
+    switch(lv_event_get_code(e)) {
+        case LV_EVENT_INVALIDATE_AREA:
+            /*Already clipped to the screen*/
+            on_invalidate(lv_event_get_param(e));
+            break;
+        case LV_EVENT_RENDER_START:
+            on_render_start();
+            break;
+        case LV_EVENT_FLUSH_START:
+            if(overlay) tint_area(lv_event_get_param(e));
+            break;
+        default:
+            break;
+    }
+}
+
+static void on_invalidate(const lv_area_t * area)
+{
+    uint16_t idx = widget_index(attribute(area));
+    uint32_t px = lv_area_get_size(area);
+    bool merged = false;
+
+    /*A widget often invalidates itself several times in one frame (text, then style):
+     *count the pixels once*/
+    for(uint32_t i = 0; i < frame_area_cnt; i++) {
+        frame_area_t * fa = &frame_areas[i];
+        if(fa->widget != idx) continue;
+        if(lv_area_is_in(area, &fa->area, 0)) {
+            px = 0;
+            merged = true;
+            break;
+        }
+        if(lv_area_is_in(&fa->area, area, 0)) {
+            px -= lv_area_get_size(&fa->area);
+            fa->area = *area;
+            merged = true;
+            break;
+        }
+    }
+    if(!merged && frame_area_cnt < INV_STATS_MAX_FRAME_AREAS) {
+        frame_areas[frame_area_cnt].widget = idx;
+        frame_areas[frame_area_cnt].area = *area;
+        frame_area_cnt++;
+    }
+
+    stats.areas++;
+    stats.inv_px += px;
+    widgets[idx].areas++;
+    widgets[idx].px += px;
+}
+
+static void on_render_start(void)
+{
+    /*The invalidated areas are joined at this point*/
+    for(uint32_t i = 0; i < stats_disp->inv_p; i++) {
+        if(stats_disp->inv_area_joined[i]) continue;
+        stats.redrawn_px += lv_area_get_size(&stats_disp->inv_areas[i]);
+    }
+    stats.frames++;
+
+    if(log_file) {
+        uint32_t t = lv_tick_get();
+        for(uint32_t i = 0; i < frame_area_cnt; i++) {
+            const frame_area_t * fa = &frame_areas[i];
+            fprintf(log_file, "%u,%u,\"%s\",%d,%d,%d,%d\n", (unsigned)frame_no, (unsigned)t,
+                    widgets[fa->widget].name, (int)fa->area.x1, (int)fa->area.y1,
+                    (int)fa->area.x2, (int)fa->area.y2);
+        }
+    }
+    frame_area_cnt = 0;
+    frame_no++;
+}
+
+/*Mix a color into the area about to be flushed; the color moves around the hue circle every frame*/
+static void tint_area(const lv_area_t * area)
+{
+    lv_draw_buf_t * buf = stats_disp->buf_act;
+    if(buf == NULL || buf->data == NULL) return;
+
+    lv_color_format_t cf = lv_display_get_color_format(stats_disp);
+    uint32_t px_size = lv_color_format_get_size(cf);
+    uint32_t stride = buf->header.stride;
+    uint8_t * row = buf->data;
+    /*Partial buffers hold only the area, direct and full ones the whole screen*/
+    if(stats_disp->render_mode != LV_DISPLAY_RENDER_MODE_PARTIAL) {
+        row += area->y1 * stride + area->x1 * px_size;
+    }
+
+    lv_color_t c = lv_color_hsv_to_rgb((uint16_t)((frame_no * 47) % 360), 100, 100);
+    uint16_t c16 = lv_color_to_u16(c);
+    int32_t w = lv_area_get_width(area);
+    int32_t h = lv_area_get_height(area);
+
+    for(int32_t y = 0; y < h; y++, row += stride) {
+        switch(cf) {
+            case LV_COLOR_FORMAT_XRGB8888:
+            case LV_COLOR_FORMAT_ARGB8888:
+            case LV_COLOR_FORMAT_RGB888:
+                for(int32_t x = 0; x < w; x++) {
+                    uint8_t * p = row + x * px_size;
+                    p[0] = (uint8_t)((p[0] * 3 + c.blue) >> 2);
+                    p[1] = (uint8_t)((p[1] * 3 + c.green) >> 2);
+                    p[2] = (uint8_t)((p[2] * 3 + c.red) >> 2);
+                }
+                break;
+            case LV_COLOR_FORMAT_RGB565: {
+                    uint16_t * p = (uint16_t *)row;
+                    for(int32_t x = 0; x < w; x++) {
+                        uint32_t r = (((p[x] >> 11) * 3) + (c16 >> 11)) >> 2;
+                        uint32_t g = ((((p[x] >> 5) & 0x3F) * 3) + ((c16 >> 5) & 0x3F)) >> 2;
+                        uint32_t b = (((p[x] & 0x1F) * 3) + (c16 & 0x1F)) >> 2;
+                        p[x] = (uint16_t)((r << 11) | (g << 5) | b);
+                    }
+                    break;
+                }
+            default:
+                return;
+        }
+    }
+}
+
+/*The deepest visible child whose area, with the extra draw size, contains `area`; topmost first*/
+static lv_obj_t * find_owner(lv_obj_t * obj, const lv_area_t * area)
+{
+    int32_t cnt = (int32_t)lv_obj_get_child_count(obj);
+    for(int32_t i = cnt - 1; i >= 0; i--) {
+        lv_obj_t * child = lv_obj_get_child(obj, i);
+        if(lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) continue;
+
+        lv_area_t a;
+        lv_obj_get_coords(child, &a);
+        int32_t ext = lv_obj_get_ext_draw_size(child);
+        lv_area_increase(&a, ext, ext);
+        if(lv_area_is_in(area, &a, 0)) return find_owner(child, area);
+    }
+    return obj;
+}
+
+static lv_obj_t * attribute(const lv_area_t * area)
+{
+    lv_obj_t * roots[] = {
+        lv_display_get_layer_sys(stats_disp),
+        lv_display_get_layer_top(stats_disp),
+        lv_display_get_screen_active(stats_disp),
+        lv_display_get_screen_prev(stats_disp),
+    };
+
+    for(uint32_t i = 0; i < sizeof(roots) / sizeof(roots[0]); i++) {
+        if(roots[i] == NULL) continue;
+        lv_obj_t * owner = find_owner(roots[i], area);
+        if(owner != roots[i]) return owner;
+    }
+    /*Nothing smaller than the screen: the screen itself (e.g. loading a page)*/
+    return roots[2];
+}
+
+/*Widgets are identified by page, class and position, so a deleted object's memory
+ *reused by another one is not mixed up with it*/
+static uint16_t widget_index(lv_obj_t * obj)
+{
+    char name[INV_STATS_NAME_LEN];
+    const char * page = page_cb ? page_cb() : NULL;
+    const char * cls = "?";
+    lv_area_t a = {0};
+    if(obj) {
+        const lv_obj_class_t * class_p = lv_obj_get_class(obj);
+        if(class_p->name) cls = class_p->name;
+        lv_obj_get_coords(obj, &a);
+    }
+    lv_snprintf(name, sizeof(name), "%s%s%s (%d,%d %dx%d)", page ? page : "", page ? ": " : "", cls,
+                (int)a.x1, (int)a.y1, (int)lv_area_get_width(&a), (int)lv_area_get_height(&a));
+
+    for(uint32_t i = 0; i < widget_cnt; i++) {
+        if(strcmp(widgets[i].name, name) == 0) return (uint16_t)i;
+    }
+    if(widget_cnt == INV_STATS_MAX_WIDGETS) return OTHER_IDX;
+
+    lv_strlcpy(widgets[widget_cnt].name, name, INV_STATS_NAME_LEN);
+    return (uint16_t)widget_cnt++;
+}
+
+static int widget_cmp(const void * a, const void * b)
+{
+    const inv_stats_widget_t * wa = a;
+    const inv_stats_widget_t * wb = b;
+    if(wa->px != wb->px) return wa->px < wb->px ? 1 : -1;
+    return (int)wb->areas - (int)wa->areas;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file inv_stats.h
+ * Invalidation statistics: which widgets make LVGL redraw, and how much.
+ *
+ * Every area invalidated on the display is attributed to the widget that
+ * invalidated it: the deepest visible object whose area (with its extra draw
+ * size) contains the invalidated area. The areas are counted per widget and
+ * per frame; `inv_stats_log_report` prints the widgets sorted by invalidated
+ * pixels per second, and a CSV log can record every area of every frame.
+ *
+ * The optional overlay tints every flushed area with a color that changes
+ * each frame, like LV_USE_REFR_DEBUG but switchable at runtime: areas that are
+ * redrawn often flash. The tint stays in the frame buffer until the area is
+ * redrawn, so it also changes the headless framebuffer checksum.
+ */
+
+#ifndef INV_STATS_H
+#define INV_STATS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Widgets tracked between two reports; the rest is counted as "(other)"*/
+#ifndef INV_STATS_MAX_WIDGETS
+  #define INV_STATS_MAX_WIDGETS     128
+#endif
+
+/*Invalidated areas kept per frame for the CSV log*/
+#ifndef INV_STATS_MAX_FRAME_AREAS
+  #define INV_STATS_MAX_FRAME_AREAS 64
+#endif
+
+#define INV_STATS_NAME_LEN          64
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    char name[INV_STATS_NAME_LEN];  /*"page: class (x,y wxh)"*/
+    uint32_t areas;                 /*Invalidations*/
+    uint64_t px;                    /*Invalidated pixels, an area inside an earlier one of the same frame is not counted*/
+} inv_stats_widget_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t areas;                 /*Invalidated areas*/
+    uint64_t inv_px;                /*Invalidated pixels before joining*/
+    uint64_t redrawn_px;            /*Pixels redrawn after joining the areas*/
+    uint32_t wall_ms;               /*UI time since the last reset*/
+} inv_stats_t;
+
+/** Returns the name of the active page, or NULL */
+typedef const char * (*inv_stats_page_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start attributing the invalidated areas of a display.
+ * @param disp      the display to hook
+ * @param page_cb   returns the active page name used in the widget names, can be NULL
+ */
+void inv_stats_init(lv_display_t * disp, inv_stats_page_cb_t page_cb);
+
+/** Tint the flushed areas with a color changing every frame */
+void inv_stats_set_overlay(bool en);
+
+/**
+ * Write every invalidated area to a CSV file: frame,time_ms,widget,x1,y1,x2,y2
+ * @return  false if the file can't be opened
+ */
+bool inv_stats_open_log(const char * path);
+
+void inv_stats_close_log(void);
+
+void inv_stats_get(inv_stats_t * stats);
+
+/**
+ * Copy the widgets counted since the last reset, most invalidated pixels first.
+ * @param out   destination, at least `INV_STATS_MAX_WIDGETS + 1` entries
+ * @return      number of widgets copied
+ */
+uint32_t inv_stats_get_widgets(inv_stats_widget_t * out);
+
+void inv_stats_reset(void);
+
+/** Print the totals and the widgets with the most invalidated pixels per second, then reset */
+void inv_stats_log_report(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*INV_STATS_H*/
@@ -0,0 +1,237 @@
+/**
+ * @file lcd_bus.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifndef _DEFAULT_SOURCE
+  #define _DEFAULT_SOURCE /* needed for usleep() */
+#endif
+
+#include "lcd_bus.h"
+#include "lvgl/src/display/lv_display_private.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <time.h>
+  #include <unistd.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_BUS_HZ              40000000
+#define DEFAULT_BITS_PER_PIXEL      16
+#define DEFAULT_DMA_CHUNK_BYTES     4092
+#define DEFAULT_CHUNK_OVERHEAD_US   2
+/*CASET + 4 bytes, RASET + 4 bytes, RAMWR*/
+#define DEFAULT_CMD_BYTES           11
+
+/*Sleeping overshoots by up to a scheduler tick; spin for the last part of a wait*/
+#define SPIN_US                     200
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map);
+static void flush_wait_cb(lv_display_t * disp);
+static uint64_t account(uint32_t px, bool last);
+static uint64_t transfer_us(uint32_t bytes);
+static void wait_until(uint64_t t_us);
+static uint64_t now_us(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lcd_bus_config_t bus_cfg;
+static bool configured;
+static lv_display_flush_cb_t driver_flush_cb;
+
+/*End of the transfer in progress*/
+static uint64_t bus_free_at;
+static uint32_t cur_frame_bytes;
+
+static lcd_bus_stats_t stats;
+static uint64_t stats_start_us;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void lcd_bus_config_init(lcd_bus_config_t * cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->bus_hz = DEFAULT_BUS_HZ;
+    cfg->bits_per_pixel = DEFAULT_BITS_PER_PIXEL;
+    cfg->dma_chunk_bytes = DEFAULT_DMA_CHUNK_BYTES;
+    cfg->chunk_overhead_us = DEFAULT_CHUNK_OVERHEAD_US;
+    cfg->cmd_bytes = DEFAULT_CMD_BYTES;
+}
+
+void lcd_bus_init(lv_display_t * disp, const lcd_bus_config_t * cfg)
+{
+    lcd_bus_configure(cfg);
+
+    driver_flush_cb = disp->flush_cb;
+    lv_display_set_flush_cb(disp, flush_cb);
+    lv_display_set_flush_wait_cb(disp, flush_wait_cb);
+}
+
+void lcd_bus_configure(const lcd_bus_config_t * cfg)
+{
+    bus_cfg = *cfg;
+    if(bus_cfg.bus_hz == 0) bus_cfg.bus_hz = DEFAULT_BUS_HZ;
+    if(bus_cfg.bits_per_pixel == 0) bus_cfg.bits_per_pixel = DEFAULT_BITS_PER_PIXEL;
+    configured = true;
+    lcd_bus_reset_stats();
+
+    lv_display_t * disp = lv_display_get_default();
+    if(disp == NULL) return;
+    uint32_t full_us = lcd_bus_transfer_us((uint32_t)(lv_display_get_horizontal_resolution(disp) *
+                                                      lv_display_get_vertical_resolution(disp)));
+    printf("LCD bus model: %.2f MHz, %u bpp, %u byte DMA chunks: full frame %.2f ms (%.1f FPS max)\n",
+           bus_cfg.bus_hz / 1000000.0, (unsigned)bus_cfg.bits_per_pixel, (unsigned)bus_cfg.dma_chunk_bytes,
+           full_us / 1000.0, full_us ? 1000000.0 / full_us : 0.0);
+}
+
+void lcd_bus_push(uint32_t px, bool last)
+{
+    if(!configured) return;
+    wait_until(account(px, last));
+}
+
+bool lcd_bus_enabled(void)
+{
+    return configured;
+}
+
+uint32_t lcd_bus_transfer_us(uint32_t px)
+{
+    return (uint32_t)transfer_us((uint32_t)(((uint64_t)px * bus_cfg.bits_per_pixel + 7) / 8));
+}
+
+void lcd_bus_get_stats(lcd_bus_stats_t * out)
+{
+    *out = stats;
+    out->wall_us = now_us() - stats_start_us;
+}
+
+void lcd_bus_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    stats_start_us = now_us();
+}
+
+void lcd_bus_log_stats(void)
+{
+    if(!configured) return;
+
+    lcd_bus_stats_t s;
+    lcd_bus_get_stats(&s);
+    if(s.wall_us == 0) return;
+
+    if(s.frames == 0) {
+        printf("LCD bus: no frames\n");
+    }
+    else {
+        printf("LCD bus: %.1f frames/s, %.1f KB/frame (min %.1f, max %.1f), %.1f flushes/frame, "
+               "%.1f MB/s, busy %.1f%%, render blocked %.2f ms/frame\n",
+               s.frames * 1000000.0 / s.wall_us, s.bytes / 1024.0 / s.frames,
+               s.frame_bytes_min / 1024.0, s.frame_bytes_max / 1024.0, (double)s.flushes / s.frames,
+               s.bytes / (double)s.wall_us, s.busy_us * 100.0 / s.wall_us, s.wait_us / 1000.0 / s.frames);
+    }
+    lcd_bus_reset_stats();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void flush_cb(lv_display_t * disp, const lv_area_t * area, uint8_t * px_map)
+{
+    account(lv_area_get_size(area), lv_display_flush_is_last(disp));
+
+    /*The driver shows the pixels and calls lv_display_flush_ready()...*/
+    driver_flush_cb(disp, area, px_map);
+    /*...but the buffer stays busy until the emulated transfer ends; flush_wait_cb() releases it*/
+    disp->flushing = 1;
+}
+
+/*Called by LVGL before it reuses the draw buffer or flushes again, like waiting for the DMA interrupt*/
+static void flush_wait_cb(lv_display_t * disp)
+{
+    uint64_t now = now_us();
+    if(bus_free_at > now) {
+        wait_until(bus_free_at);
+        stats.wait_us += now_us() - now;
+    }
+    lv_display_flush_ready(disp);
+}
+
+/*Start the transfer of `px` pixels on the bus and count it; returns the time it ends*/
+static uint64_t account(uint32_t px, bool last)
+{
+    uint32_t px_bytes = (uint32_t)(((uint64_t)px * bus_cfg.bits_per_pixel + 7) / 8);
+    uint64_t now = now_us();
+
+    /*DMA starts now, or when the previous transfer ends if nobody waited for it*/
+    uint64_t start = bus_free_at > now ? bus_free_at : now;
+    uint64_t us = transfer_us(px_bytes);
+    bus_free_at = start + us;
+
+    stats.flushes++;
+    stats.bytes += px_bytes + bus_cfg.cmd_bytes;
+    stats.busy_us += us;
+    cur_frame_bytes += px_bytes + bus_cfg.cmd_bytes;
+
+    if(last) {
+        if(stats.frames == 0 || cur_frame_bytes < stats.frame_bytes_min) stats.frame_bytes_min = cur_frame_bytes;
+        if(cur_frame_bytes > stats.frame_bytes_max) stats.frame_bytes_max = cur_frame_bytes;
+        stats.frame_bytes_last = cur_frame_bytes;
+        stats.frames++;
+        cur_frame_bytes = 0;
+    }
+    return bus_free_at;
+}
+
+static uint64_t transfer_us(uint32_t bytes)
+{
+    uint64_t chunks = 1;
+    if(bus_cfg.dma_chunk_bytes && bytes) chunks = (bytes + bus_cfg.dma_chunk_bytes - 1) / bus_cfg.dma_chunk_bytes;
+
+    uint64_t bits = (uint64_t)(bytes + bus_cfg.cmd_bytes) * 8;
+    return bits * 1000000 / bus_cfg.bus_hz + chunks * bus_cfg.chunk_overhead_us;
+}
+
+static void wait_until(uint64_t t_us)
+{
+    uint64_t now;
+    while((now = now_us()) < t_us) {
+        uint64_t left = t_us - now;
+        if(left <= SPIN_US) continue;
+#ifdef _WIN32
+        Sleep((DWORD)((left - SPIN_US) / 1000));
+#else
+        usleep((useconds_t)(left - SPIN_US));
+#endif
+    }
+}
+
+static uint64_t now_us(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER cnt;
+    if(freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+    return (uint64_t)(cnt.QuadPart * 1000000 / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+#endif
+}
@@ -0,0 +1,95 @@
+/**
+ * @file lcd_bus.h
+ * Emulates the bandwidth of the device's SPI LCD bus in the display flush path.
+ *
+ * The driver's flush callback still runs immediately (the window or framebuffer
+ * is updated), but the draw buffer stays busy until the emulated transfer of the
+ * flushed area has finished: LVGL blocks in the flush wait callback exactly
+ * where it would wait for the DMA-complete interrupt on the device. The FPS
+ * measured on the desktop then includes the bus bottleneck.
+ *
+ * Transfer time of one flush:
+ *   (cmd_bytes + px * bits_per_pixel / 8) * 8 / bus_hz + chunks * chunk_overhead_us
+ * where `chunks` is the payload split into `dma_chunk_bytes` pieces.
+ */
+
+#ifndef LCD_BUS_H
+#define LCD_BUS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef struct {
+    uint32_t bus_hz;            /*SPI clock*/
+    uint32_t bits_per_pixel;    /*Pixel format on the wire, e.g. 16 for RGB565*/
+    uint32_t dma_chunk_bytes;   /*Largest DMA transfer, 0: the whole area at once*/
+    uint32_t chunk_overhead_us; /*Gap between two DMA chunks (interrupt, re-arming)*/
+    uint32_t cmd_bytes;         /*Command bytes per flush (column/row address set, memory write)*/
+} lcd_bus_config_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t flushes;
+    uint64_t bytes;             /*Pixel and command bytes sent*/
+    uint32_t frame_bytes_last;
+    uint32_t frame_bytes_min;
+    uint32_t frame_bytes_max;
+    uint64_t busy_us;           /*Time the bus was transferring*/
+    uint64_t wait_us;           /*Time LVGL was blocked waiting for the bus*/
+    uint64_t wall_us;           /*Time since the last reset*/
+} lcd_bus_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/** Defaults of the device: 40 MHz, RGB565, 4092 byte DMA chunks */
+void lcd_bus_config_init(lcd_bus_config_t * cfg);
+
+/**
+ * Put the bus model in front of the display's flush callback.
+ * Call it after the display driver has set its flush callback. Only one display is supported.
+ */
+void lcd_bus_init(lv_display_t * disp, const lcd_bus_config_t * cfg);
+
+/**
+ * Set up the model without hooking a display, for a flush path that pushes
+ * the pixels itself with `lcd_bus_push` (e.g. the async flush thread).
+ */
+void lcd_bus_configure(const lcd_bus_config_t * cfg);
+
+/**
+ * Send `px` pixels: blocks for the transfer time and counts the bytes.
+ * @param last  true for the last area of a frame
+ */
+void lcd_bus_push(uint32_t px, bool last);
+
+bool lcd_bus_enabled(void);
+
+/** Emulated time to send `px` pixels in one flush */
+uint32_t lcd_bus_transfer_us(uint32_t px);
+
+void lcd_bus_get_stats(lcd_bus_stats_t * stats);
+
+void lcd_bus_reset_stats(void);
+
+/** Print the bytes per frame, bus load and render stalls since the last call, then reset */
+void lcd_bus_log_stats(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LCD_BUS_H*/
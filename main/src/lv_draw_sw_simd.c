@@ -0,0 +1,625 @@
+/**
+ * @file lv_draw_sw_simd.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_sw_simd.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  #define SIMD_X86 1
+  #include <immintrin.h>
+#else
+  #define SIMD_X86 0
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#if SIMD_X86
+  /*The kernels are compiled for their instruction set regardless of -march and only called when the CPU has it*/
+  #define TARGET_SSE41 __attribute__((target("sse4.1")))
+  #define TARGET_AVX2  __attribute__((target("avx2")))
+#endif
+
+#define RGB_MASK    0x00FFFFFFu
+#define ALPHA_MASK  0xFF000000u
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Mix `w` pixels of `dest` with `src` (ARGB8888, alpha used) or with `color` if `src` is NULL.
+ * The mix ratio is the product of the source alpha, `mask` (if not NULL) and `opa` (if `use_opa`).
+ */
+typedef void (*mix_row_cb_t)(uint32_t * dest, const uint32_t * src, uint32_t color,
+                             const uint8_t * mask, uint32_t opa, bool use_opa, int32_t w);
+typedef void (*fill_row_cb_t)(uint32_t * dest, uint32_t color, int32_t w);
+typedef void (*fill_row16_cb_t)(uint16_t * dest, uint16_t color, int32_t w);
+/*Copy RGB565 into the RGB bytes of `dest`; `alpha` true: set the alpha byte to 0xFF, false: keep it*/
+typedef void (*rgb565_row_cb_t)(uint32_t * dest, const uint16_t * src, bool alpha, int32_t w);
+typedef void (*to_rgb565_row_cb_t)(uint16_t * dest, const uint32_t * src, int32_t w);
+typedef void (*swap_row16_cb_t)(uint16_t * buf, int32_t w);
+
+typedef struct {
+    mix_row_cb_t mix_row;
+    fill_row_cb_t fill_row;
+    fill_row16_cb_t fill_row16;
+    rgb565_row_cb_t rgb565_row;
+    to_rgb565_row_cb_t to_rgb565_row;
+    swap_row16_cb_t swap_row16;
+} kernels_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_draw_sw_simd_level_t level_from_env(lv_draw_sw_simd_level_t detected);
+static void count_call(void);
+
+static inline uint32_t mix_px(uint32_t s, uint32_t d, uint32_t mix);
+static inline uint32_t rgb565_to_rgb(uint16_t c);
+static void mix_row_c(uint32_t * dest, const uint32_t * src, uint32_t color,
+                      const uint8_t * mask, uint32_t opa, bool use_opa, int32_t w);
+static void fill_row_c(uint32_t * dest, uint32_t color, int32_t w);
+static void fill_row16_c(uint16_t * dest, uint16_t color, int32_t w);
+static void rgb565_row_c(uint32_t * dest, const uint16_t * src, bool alpha, int32_t w);
+static void to_rgb565_row_c(uint16_t * dest, const uint32_t * src, int32_t w);
+static void swap_row16_c(uint16_t * buf, int32_t w);
+
+#if SIMD_X86
+TARGET_SSE41 static void mix_row_sse41(uint32_t * dest, const uint32_t * src, uint32_t color,
+                                       const uint8_t * mask, uint32_t opa, bool use_opa, int32_t w);
+TARGET_SSE41 static void fill_row_sse41(uint32_t * dest, uint32_t color, int32_t w);
+TARGET_SSE41 static void fill_row16_sse41(uint16_t * dest, uint16_t color, int32_t w);
+TARGET_SSE41 static void rgb565_row_sse41(uint32_t * dest, const uint16_t * src, bool alpha, int32_t w);
+TARGET_SSE41 static void to_rgb565_row_sse41(uint16_t * dest, const uint32_t * src, int32_t w);
+TARGET_SSE41 static void swap_row16_sse41(uint16_t * buf, int32_t w);
+
+TARGET_AVX2 static void mix_row_avx2(uint32_t * dest, const uint32_t * src, uint32_t color,
+                                     const uint8_t * mask, uint32_t opa, bool use_opa, int32_t w);
+TARGET_AVX2 static void fill_row_avx2(uint32_t * dest, uint32_t color, int32_t w);
+TARGET_AVX2 static void fill_row16_avx2(uint16_t * dest, uint16_t color, int32_t w);
+TARGET_AVX2 static void rgb565_row_avx2(uint32_t * dest, const uint16_t * src, bool alpha, int32_t w);
+TARGET_AVX2 static void to_rgb565_row_avx2(uint16_t * dest, const uint32_t * src, int32_t w);
+TARGET_AVX2 static void swap_row16_avx2(uint16_t * buf, int32_t w);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const kernels_t kernels[] = {
+    [LV_DRAW_SW_SIMD_NONE] = { mix_row_c, fill_row_c, fill_row16_c, rgb565_row_c, to_rgb565_row_c, swap_row16_c },
+#if SIMD_X86
+    [LV_DRAW_SW_SIMD_SSE41] = { mix_row_sse41, fill_row_sse41, fill_row16_sse41, rgb565_row_sse41, to_rgb565_row_sse41, swap_row16_sse41 },
+    [LV_DRAW_SW_SIMD_AVX2] = { mix_row_avx2, fill_row_avx2, fill_row16_avx2, rgb565_row_avx2, to_rgb565_row_avx2, swap_row16_avx2 },
+#else
+    [LV_DRAW_SW_SIMD_SSE41] = { mix_row_c, fill_row_c, fill_row16_c, rgb565_row_c, to_rgb565_row_c, swap_row16_c },
+    [LV_DRAW_SW_SIMD_AVX2] = { mix_row_c, fill_row_c, fill_row16_c, rgb565_row_c, to_rgb565_row_c, swap_row16_c },
+#endif
+};
+
+/*-1: not initialized yet. Set once and read from every draw unit thread; a racy first init gives the same value*/
+static volatile int32_t cur_level = -1;
+static volatile uint32_t call_cnt;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+lv_draw_sw_simd_level_t lv_draw_sw_simd_detect(void)
+{
+#if SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) return LV_DRAW_SW_SIMD_AVX2;
+    if(__builtin_cpu_supports("sse4.1")) return LV_DRAW_SW_SIMD_SSE41;
+#endif
+    return LV_DRAW_SW_SIMD_NONE;
+}
+
+void lv_draw_sw_simd_set_level(lv_draw_sw_simd_level_t level)
+{
+    lv_draw_sw_simd_level_t detected = lv_draw_sw_simd_detect();
+    cur_level = level > detected ? detected : level;
+}
+
+lv_draw_sw_simd_level_t lv_draw_sw_simd_get_level(void)
+{
+    int32_t level = cur_level;
+    if(level < 0) {
+        level = level_from_env(lv_draw_sw_simd_detect());
+        cur_level = level;
+    }
+    return (lv_draw_sw_simd_level_t)level;
+}
+
+const char * lv_draw_sw_simd_level_name(lv_draw_sw_simd_level_t level)
+{
+    switch(level) {
+        case LV_DRAW_SW_SIMD_SSE41:
+            return "sse41";
+        case LV_DRAW_SW_SIMD_AVX2:
+            return "avx2";
+        default:
+            return "none";
+    }
+}
+
+uint32_t lv_draw_sw_simd_get_calls(void)
+{
+    return call_cnt;
+}
+
+lv_result_t lv_draw_sw_simd_color_to_xrgb8888(lv_draw_sw_blend_fill_dsc_t * dsc, uint32_t dest_px_size)
+{
+    lv_draw_sw_simd_level_t level = lv_draw_sw_simd_get_level();
+    if(level == LV_DRAW_SW_SIMD_NONE || dest_px_size != 4) return LV_RESULT_INVALID;
+
+    const kernels_t * k = &kernels[level];
+    uint8_t * dest = dsc->dest_buf;
+    const uint8_t * mask = dsc->mask_buf;
+    uint32_t color = lv_color_to_u32(dsc->color);
+    bool use_opa = dsc->opa < LV_OPA_MAX;
+
+    for(int32_t y = 0; y < dsc->dest_h; y++) {
+        if(mask == NULL && !use_opa) k->fill_row((uint32_t *)dest, color, dsc->dest_w);
+        else k->mix_row((uint32_t *)dest, NULL, color, mask, dsc->opa, use_opa, dsc->dest_w);
+
+        dest += dsc->dest_stride;
+        if(mask) mask += dsc->mask_stride;
+    }
+
+    count_call();
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_draw_sw_simd_argb8888_to_xrgb8888(lv_draw_sw_blend_image_dsc_t * dsc, uint32_t dest_px_size)
+{
+    lv_draw_sw_simd_level_t level = lv_draw_sw_simd_get_level();
+    if(level == LV_DRAW_SW_SIMD_NONE || dest_px_size != 4 || dsc->blend_mode != LV_BLEND_MODE_NORMAL) {
+        return LV_RESULT_INVALID;
+    }
+
+    const kernels_t * k = &kernels[level];
+    uint8_t * dest = dsc->dest_buf;
+    const uint8_t * src = dsc->src_buf;
+    const uint8_t * mask = dsc->mask_buf;
+    bool use_opa = dsc->opa < LV_OPA_MAX;
+
+    for(int32_t y = 0; y < dsc->dest_h; y++) {
+        k->mix_row((uint32_t *)dest, (const uint32_t *)src, 0, mask, dsc->opa, use_opa, dsc->dest_w);
+
+        dest += dsc->dest_stride;
+        src += dsc->src_stride;
+        if(mask) mask += dsc->mask_stride;
+    }
+
+    count_call();
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_draw_sw_simd_rgb565_to_xrgb8888(lv_draw_sw_blend_image_dsc_t * dsc, uint32_t dest_px_size)
+{
+    /*Only the plain copy; opa and masks are rare with RGB565 images and stay in C*/
+    lv_draw_sw_simd_level_t level = lv_draw_sw_simd_get_level();
+    if(level == LV_DRAW_SW_SIMD_NONE || dest_px_size != 4 || dsc->blend_mode != LV_BLEND_MODE_NORMAL ||
+       dsc->mask_buf != NULL || dsc->opa < LV_OPA_MAX) {
+        return LV_RESULT_INVALID;
+    }
+
+    const kernels_t * k = &kernels[level];
+    uint8_t * dest = dsc->dest_buf;
+    const uint8_t * src = dsc->src_buf;
+
+    for(int32_t y = 0; y < dsc->dest_h; y++) {
+        k->rgb565_row((uint32_t *)dest, (const uint16_t *)src, false, dsc->dest_w);
+        dest += dsc->dest_stride;
+        src += dsc->src_stride;
+    }
+
+    count_call();
+    return LV_RESULT_OK;
+}
+
+lv_result_t lv_draw_sw_simd_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t * dsc)
+{
+    lv_draw_sw_simd_level_t level = lv_draw_sw_simd_get_level();
+    if(level == LV_DRAW_SW_SIMD_NONE) return LV_RESULT_INVALID;
+
+    const kernels_t * k = &kernels[level];
+    uint8_t * dest = dsc->dest_buf;
+    uint16_t color = lv_color_to_u16(dsc->color);
+
+    for(int32_t y = 0; y < dsc->dest_h; y++) {
+        k->fill_row16((uint16_t *)dest, color, dsc->dest_w);
+        dest += dsc->dest_stride;
+    }
+
+    count_call();
+    return LV_RESULT_OK;
+}
+
+void lv_draw_sw_simd_xrgb8888_to_rgb565(const uint32_t * src, uint16_t * dest, uint32_t px_cnt)
+{
+    kernels[lv_draw_sw_simd_get_level()].to_rgb565_row(dest, src, (int32_t)px_cnt);
+}
+
+void lv_draw_sw_simd_rgb565_to_xrgb8888_buf(const uint16_t * src, uint32_t * dest, uint32_t px_cnt)
+{
+    kernels[lv_draw_sw_simd_get_level()].rgb565_row(dest, src, true, (int32_t)px_cnt);
+}
+
+void lv_draw_sw_simd_rgb565_swap(void * buf, uint32_t px_cnt)
+{
+    kernels[lv_draw_sw_simd_get_level()].swap_row16(buf, (int32_t)px_cnt);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_draw_sw_simd_level_t level_from_env(lv_draw_sw_simd_level_t detected)
+{
+    const char * env = getenv("LV_DRAW_SW_SIMD");
+    lv_draw_sw_simd_level_t level = detected;
+    if(env == NULL) return level;
+
+    if(strcmp(env, "none") == 0) level = LV_DRAW_SW_SIMD_NONE;
+    else if(strcmp(env, "sse41") == 0) level = LV_DRAW_SW_SIMD_SSE41;
+    else if(strcmp(env, "avx2") == 0) level = LV_DRAW_SW_SIMD_AVX2;
+
+    return level > detected ? detected : level;
+}
+
+static void count_call(void)
+{
+#if defined(__GNUC__)
+    __atomic_fetch_add(&call_cnt, 1, __ATOMIC_RELAXED);
+#else
+    call_cnt++;
+#endif
+}
+
+/*Same arithmetic as LVGL's lv_color_24_24_mix(); the alpha byte of `d` is kept*/
+static inline uint32_t mix_px(uint32_t s, uint32_t d, uint32_t mix)
+{
+    if(mix == 0) return d;
+    if(mix >= LV_OPA_MAX) return (s & RGB_MASK) | (d & ALPHA_MASK);
+
+    uint32_t mix_inv = 255 - mix;
+    uint32_t b = ((s & 0xFF) * mix + (d & 0xFF) * mix_inv) >> 8;
+    uint32_t g = (((s >> 8) & 0xFF) * mix + ((d >> 8) & 0xFF) * mix_inv) >> 8;
+    uint32_t r = (((s >> 16) & 0xFF) * mix + ((d >> 16) & 0xFF) * mix_inv) >> 8;
+    return (d & ALPHA_MASK) | (r << 16) | (g << 8) | b;
+}
+
+/*Same expansion as LVGL's RGB565 image blending*/
+static inline uint32_t rgb565_to_rgb(uint16_t c)
+{
+    uint32_t r = (((c >> 11) & 0x1F) * 2106) >> 8;
+    uint32_t g = (((c >> 5) & 0x3F) * 1037) >> 8;
+    uint32_t b = ((c & 0x1F) * 2106) >> 8;
+    return (r << 16) | (g << 8) | b;
+}
+
+static void mix_row_c(uint32_t * dest, const uint32_t * src, uint32_t color,
+                      const uint8_t * mask, uint32_t opa, bool use_opa, int32_t w)
+{
+    for(int32_t x = 0; x < w; x++) {
+        uint32_t s = src ? src[x] : color;
+        uint32_t mix;
+        if(src) {
+            uint32_t a = s >> 24;
+            if(mask && use_opa) mix = (a * mask[x] * opa) >> 16;
+            else if(mask) mix = (a * mask[x]) >> 8;
+            else if(use_opa) mix = (a * opa) >> 8;
+            else mix = a;
+        }
+        else {
+            if(mask && use_opa) mix = (mask[x] * opa) >> 8;
+            else if(mask) mix = mask[x];
+            else mix = opa;
+        }
+        dest[x] = mix_px(s, dest[x], mix);
+    }
+}
+
+static void fill_row_c(uint32_t * dest, uint32_t color, int32_t w)
+{
+    for(int32_t x = 0; x < w; x++) dest[x] = color;
+}
+
+static void fill_row16_c(uint16_t * dest, uint16_t color, int32_t w)
+{
+    for(int32_t x = 0; x < w; x++) dest[x] = color;
+}
+
+static void rgb565_row_c(uint32_t * dest, const uint16_t * src, bool alpha, int32_t w)
+{
+    for(int32_t x = 0; x < w; x++) {
+        uint32_t a = alpha ? ALPHA_MASK : (dest[x] & ALPHA_MASK);
+        dest[x] = a | rgb565_to_rgb(src[x]);
+    }
+}
+
+/*Truncating like lv_color_to_u16()*/
+static void to_rgb565_row_c(uint16_t * dest, const uint32_t * src, int32_t w)
+{
+    for(int32_t x = 0; x < w; x++) {
+        uint32_t p = src[x];
+        dest[x] = (uint16_t)(((p >> 8) & 0xF800) | ((p >> 5) & 0x07E0) | ((p >> 3) & 0x001F));
+    }
+}
+
+static void swap_row16_c(uint16_t * buf, int32_t w)
+{
+    for(int32_t x = 0; x < w; x++) buf[x] = (uint16_t)((buf[x] << 8) | (buf[x] >> 8));
+}
+
+#if SIMD_X86
+
+/*--------------------
+ * SSE4.1, 4 pixels
+ *-------------------*/
+
+/*Vector version of mix_px(): `m` holds the mix ratio of each pixel in its 32 bit lane*/
+TARGET_SSE41 static inline __m128i mix4_sse41(__m128i s, __m128i d, __m128i m)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c255 = _mm_set1_epi16(255);
+    const __m128i rgb = _mm_set1_epi32(RGB_MASK);
+    /*Broadcast the ratio to the 4 bytes of its pixel*/
+    const __m128i bcast = _mm_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+
+    __m128i mb = _mm_shuffle_epi8(m, bcast);
+    __m128i m_lo = _mm_unpacklo_epi8(mb, zero);
+    __m128i m_hi = _mm_unpackhi_epi8(mb, zero);
+
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), m_lo),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(c255, m_lo)));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), m_hi),
+                               _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(c255, m_hi)));
+    __m128i res = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+
+    res = _mm_blendv_epi8(res, s, _mm_cmpgt_epi32(m, _mm_set1_epi32(LV_OPA_MAX - 1)));
+    res = _mm_blendv_epi8(res, d, _mm_cmpeq_epi32(m, zero));
+    return _mm_or_si128(_mm_and_si128(res, rgb), _mm_andnot_si128(rgb, d));
+}
+
+TARGET_SSE41 static void mix_row_sse41(uint32_t * dest, const uint32_t * src, uint32_t color,
+                                       const uint8_t * mask, uint32_t opa, bool use_opa, int32_t w)
+{
+    const __m128i opa_v = _mm_set1_epi32((int32_t)opa);
+    __m128i s = _mm_set1_epi32((int32_t)color);
+    __m128i m = _mm_set1_epi32((int32_t)opa);
+    int32_t x = 0;
+
+    for(; x + 4 <= w; x += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i *)(dest + x));
+        __m128i mv = m;
+        if(mask) {
+            int32_t mask4;
+            memcpy(&mask4, mask + x, sizeof(mask4));
+            mv = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(mask4));
+        }
+
+        if(src) {
+            s = _mm_loadu_si128((const __m128i *)(src + x));
+            __m128i a = _mm_srli_epi32(s, 24);
+            if(mask && use_opa) m = _mm_srli_epi32(_mm_mullo_epi32(_mm_mullo_epi32(a, mv), opa_v), 16);
+            else if(mask) m = _mm_srli_epi32(_mm_mullo_epi32(a, mv), 8);
+            else if(use_opa) m = _mm_srli_epi32(_mm_mullo_epi32(a, opa_v), 8);
+            else m = a;
+        }
+        else if(mask) {
+            m = use_opa ? _mm_srli_epi32(_mm_mullo_epi32(mv, opa_v), 8) : mv;
+        }
+
+        _mm_storeu_si128((__m128i *)(dest + x), mix4_sse41(s, d, m));
+    }
+
+    mix_row_c(dest + x, src ? src + x : NULL, color, mask ? mask + x : NULL, opa, use_opa, w - x);
+}
+
+TARGET_SSE41 static void fill_row_sse41(uint32_t * dest, uint32_t color, int32_t w)
+{
+    const __m128i c = _mm_set1_epi32((int32_t)color);
+    int32_t x = 0;
+    for(; x + 4 <= w; x += 4) _mm_storeu_si128((__m128i *)(dest + x), c);
+    fill_row_c(dest + x, color, w - x);
+}
+
+TARGET_SSE41 static void fill_row16_sse41(uint16_t * dest, uint16_t color, int32_t w)
+{
+    const __m128i c = _mm_set1_epi16((int16_t)color);
+    int32_t x = 0;
+    for(; x + 8 <= w; x += 8) _mm_storeu_si128((__m128i *)(dest + x), c);
+    fill_row16_c(dest + x, color, w - x);
+}
+
+/*Vector version of rgb565_to_rgb() for 4 pixels*/
+TARGET_SSE41 static inline __m128i rgb565_expand4_sse41(__m128i c)
+{
+    __m128i r = _mm_srli_epi32(_mm_mullo_epi32(_mm_and_si128(_mm_srli_epi32(c, 11), _mm_set1_epi32(0x1F)),
+                                               _mm_set1_epi32(2106)), 8);
+    __m128i g = _mm_srli_epi32(_mm_mullo_epi32(_mm_and_si128(_mm_srli_epi32(c, 5), _mm_set1_epi32(0x3F)),
+                                               _mm_set1_epi32(1037)), 8);
+    __m128i b = _mm_srli_epi32(_mm_mullo_epi32(_mm_and_si128(c, _mm_set1_epi32(0x1F)),
+                                               _mm_set1_epi32(2106)), 8);
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8)), b);
+}
+
+TARGET_SSE41 static void rgb565_row_sse41(uint32_t * dest, const uint16_t * src, bool alpha, int32_t w)
+{
+    const __m128i alpha_mask = _mm_set1_epi32((int32_t)ALPHA_MASK);
+    int32_t x = 0;
+    for(; x + 4 <= w; x += 4) {
+        __m128i c = _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)(src + x)));
+        __m128i a = alpha ? alpha_mask : _mm_and_si128(_mm_loadu_si128((const __m128i *)(dest + x)), alpha_mask);
+        _mm_storeu_si128((__m128i *)(dest + x), _mm_or_si128(a, rgb565_expand4_sse41(c)));
+    }
+    rgb565_row_c(dest + x, src + x, alpha, w - x);
+}
+
+TARGET_SSE41 static void to_rgb565_row_sse41(uint16_t * dest, const uint32_t * src, int32_t w)
+{
+    int32_t x = 0;
+    for(; x + 8 <= w; x += 8) {
+        __m128i p0 = _mm_loadu_si128((const __m128i *)(src + x));
+        __m128i p1 = _mm_loadu_si128((const __m128i *)(src + x + 4));
+        __m128i v0 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p0, 8), _mm_set1_epi32(0xF800)),
+                                               _mm_and_si128(_mm_srli_epi32(p0, 5), _mm_set1_epi32(0x07E0))),
+                                  _mm_and_si128(_mm_srli_epi32(p0, 3), _mm_set1_epi32(0x001F)));
+        __m128i v1 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(p1, 8), _mm_set1_epi32(0xF800)),
+                                               _mm_and_si128(_mm_srli_epi32(p1, 5), _mm_set1_epi32(0x07E0))),
+                                  _mm_and_si128(_mm_srli_epi32(p1, 3), _mm_set1_epi32(0x001F)));
+        _mm_storeu_si128((__m128i *)(dest + x), _mm_packus_epi32(v0, v1));
+    }
+    to_rgb565_row_c(dest + x, src + x, w - x);
+}
+
+TARGET_SSE41 static void swap_row16_sse41(uint16_t * buf, int32_t w)
+{
+    const __m128i swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    int32_t x = 0;
+    for(; x + 8 <= w; x += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(buf + x));
+        _mm_storeu_si128((__m128i *)(buf + x), _mm_shuffle_epi8(v, swap));
+    }
+    swap_row16_c(buf + x, w - x);
+}
+
+/*--------------------
+ * AVX2, 8 pixels
+ *-------------------*/
+
+TARGET_AVX2 static inline __m256i mix8_avx2(__m256i s, __m256i d, __m256i m)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c255 = _mm256_set1_epi16(255);
+    const __m256i rgb = _mm256_set1_epi32(RGB_MASK);
+    /*The byte shuffle works within the 128 bit lanes, so the pattern is repeated*/
+    const __m256i bcast = _mm256_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12,
+                                           0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+
+    /*unpack and pack also work within the lanes, so the pixel order is kept*/
+    __m256i mb = _mm256_shuffle_epi8(m, bcast);
+    __m256i m_lo = _mm256_unpacklo_epi8(mb, zero);
+    __m256i m_hi = _mm256_unpackhi_epi8(mb, zero);
+
+    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), m_lo),
+                                  _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(c255, m_lo)));
+    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), m_hi),
+                                  _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(c255, m_hi)));
+    __m256i res = _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+
+    res = _mm256_blendv_epi8(res, s, _mm256_cmpgt_epi32(m, _mm256_set1_epi32(LV_OPA_MAX - 1)));
+    res = _mm256_blendv_epi8(res, d, _mm256_cmpeq_epi32(m, zero));
+    return _mm256_or_si256(_mm256_and_si256(res, rgb), _mm256_andnot_si256(rgb, d));
+}
+
+TARGET_AVX2 static void mix_row_avx2(uint32_t * dest, const uint32_t * src, uint32_t color,
+                                     const uint8_t * mask, uint32_t opa, bool use_opa, int32_t w)
+{
+    const __m256i opa_v = _mm256_set1_epi32((int32_t)opa);
+    __m256i s = _mm256_set1_epi32((int32_t)color);
+    __m256i m = _mm256_set1_epi32((int32_t)opa);
+    int32_t x = 0;
+
+    for(; x + 8 <= w; x += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)(dest + x));
+        __m256i mv = mask ? _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(mask + x))) : m;
+
+        if(src) {
+            s = _mm256_loadu_si256((const __m256i *)(src + x));
+            __m256i a = _mm256_srli_epi32(s, 24);
+            if(mask && use_opa) m = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_mullo_epi32(a, mv), opa_v), 16);
+            else if(mask) m = _mm256_srli_epi32(_mm256_mullo_epi32(a, mv), 8);
+            else if(use_opa) m = _mm256_srli_epi32(_mm256_mullo_epi32(a, opa_v), 8);
+            else m = a;
+        }
+        else if(mask) {
+            m = use_opa ? _mm256_srli_epi32(_mm256_mullo_epi32(mv, opa_v), 8) : mv;
+        }
+
+        _mm256_storeu_si256((__m256i *)(dest + x), mix8_avx2(s, d, m));
+    }
+
+    mix_row_c(dest + x, src ? src + x : NULL, color, mask ? mask + x : NULL, opa, use_opa, w - x);
+}
+
+TARGET_AVX2 static void fill_row_avx2(uint32_t * dest, uint32_t color, int32_t w)
+{
+    const __m256i c = _mm256_set1_epi32((int32_t)color);
+    int32_t x = 0;
+    for(; x + 8 <= w; x += 8) _mm256_storeu_si256((__m256i *)(dest + x), c);
+    fill_row_c(dest + x, color, w - x);
+}
+
+TARGET_AVX2 static void fill_row16_avx2(uint16_t * dest, uint16_t color, int32_t w)
+{
+    const __m256i c = _mm256_set1_epi16((int16_t)color);
+    int32_t x = 0;
+    for(; x + 16 <= w; x += 16) _mm256_storeu_si256((__m256i *)(dest + x), c);
+    fill_row16_c(dest + x, color, w - x);
+}
+
+TARGET_AVX2 static inline __m256i rgb565_expand8_avx2(__m256i c)
+{
+    __m256i r = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(c, 11), _mm256_set1_epi32(0x1F)),
+                                                     _mm256_set1_epi32(2106)), 8);
+    __m256i g = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(_mm256_srli_epi32(c, 5), _mm256_set1_epi32(0x3F)),
+                                                     _mm256_set1_epi32(1037)), 8);
+    __m256i b = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_and_si256(c, _mm256_set1_epi32(0x1F)),
+                                                     _mm256_set1_epi32(2106)), 8);
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(g, 8)), b);
+}
+
+TARGET_AVX2 static void rgb565_row_avx2(uint32_t * dest, const uint16_t * src, bool alpha, int32_t w)
+{
+    const __m256i alpha_mask = _mm256_set1_epi32((int32_t)ALPHA_MASK);
+    int32_t x = 0;
+    for(; x + 8 <= w; x += 8) {
+        __m256i c = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + x)));
+        __m256i a = alpha ? alpha_mask : _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(dest + x)), alpha_mask);
+        _mm256_storeu_si256((__m256i *)(dest + x), _mm256_or_si256(a, rgb565_expand8_avx2(c)));
+    }
+    rgb565_row_c(dest + x, src + x, alpha, w - x);
+}
+
+TARGET_AVX2 static void to_rgb565_row_avx2(uint16_t * dest, const uint32_t * src, int32_t w)
+{
+    int32_t x = 0;
+    for(; x + 16 <= w; x += 16) {
+        __m256i p0 = _mm256_loadu_si256((const __m256i *)(src + x));
+        __m256i p1 = _mm256_loadu_si256((const __m256i *)(src + x + 8));
+        __m256i v0 = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(p0, 8), _mm256_set1_epi32(0xF800)),
+                                                     _mm256_and_si256(_mm256_srli_epi32(p0, 5), _mm256_set1_epi32(0x07E0))),
+                                     _mm256_and_si256(_mm256_srli_epi32(p0, 3), _mm256_set1_epi32(0x001F)));
+        __m256i v1 = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(p1, 8), _mm256_set1_epi32(0xF800)),
+                                                     _mm256_and_si256(_mm256_srli_epi32(p1, 5), _mm256_set1_epi32(0x07E0))),
+                                     _mm256_and_si256(_mm256_srli_epi32(p1, 3), _mm256_set1_epi32(0x001F)));
+        /*The in-lane pack gives v0[0..3] v1[0..3] v0[4..7] v1[4..7]; reorder the 64 bit quarters*/
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(v0, v1), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm256_storeu_si256((__m256i *)(dest + x), packed);
+    }
+    to_rgb565_row_c(dest + x, src + x, w - x);
+}
+
+TARGET_AVX2 static void swap_row16_avx2(uint16_t * buf, int32_t w)
+{
+    const __m256i swap = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                          1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    int32_t x = 0;
+    for(; x + 16 <= w; x += 16) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(buf + x));
+        _mm256_storeu_si256((__m256i *)(buf + x), _mm256_shuffle_epi8(v, swap));
+    }
+    swap_row16_c(buf + x, w - x);
+}
+
+#endif /*SIMD_X86*/
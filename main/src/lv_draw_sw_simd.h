@@ -0,0 +1,107 @@
+/**
+ * @file lv_draw_sw_simd.h
+ * SSE4.1 / AVX2 kernels for LVGL's software blending, hooked in with
+ * `LV_USE_DRAW_SW_ASM == LV_DRAW_SW_ASM_CUSTOM` and `LV_DRAW_SW_ASM_CUSTOM_INCLUDE`.
+ *
+ * The instruction set is selected at runtime from the CPU features. When no
+ * kernel applies (other CPU, other blend mode, RGB888 destination) the hooks
+ * return LV_RESULT_INVALID and LVGL's C implementation runs instead.
+ * The kernels produce the same bytes as the C implementation; `simd_bench`
+ * verifies that and measures the throughput.
+ */
+
+#ifndef LV_DRAW_SW_SIMD_H
+#define LV_DRAW_SW_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+#include "lvgl/src/draw/sw/blend/lv_draw_sw_blend_private.h"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    LV_DRAW_SW_SIMD_NONE,       /*Use LVGL's C implementation*/
+    LV_DRAW_SW_SIMD_SSE41,
+    LV_DRAW_SW_SIMD_AVX2,
+} lv_draw_sw_simd_level_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/** Best level supported by the CPU (and the compiler) */
+lv_draw_sw_simd_level_t lv_draw_sw_simd_detect(void);
+
+/**
+ * Select the kernels to use; clamped to `lv_draw_sw_simd_detect()`.
+ * Also honored: the LV_DRAW_SW_SIMD environment variable (none/sse41/avx2) at the first use.
+ */
+void lv_draw_sw_simd_set_level(lv_draw_sw_simd_level_t level);
+
+lv_draw_sw_simd_level_t lv_draw_sw_simd_get_level(void);
+
+const char * lv_draw_sw_simd_level_name(lv_draw_sw_simd_level_t level);
+
+/** Number of blend calls handled by the kernels (to check that the hooks are wired) */
+uint32_t lv_draw_sw_simd_get_calls(void);
+
+/*Blend hooks, called by LVGL through the macros below*/
+lv_result_t lv_draw_sw_simd_color_to_xrgb8888(lv_draw_sw_blend_fill_dsc_t * dsc, uint32_t dest_px_size);
+lv_result_t lv_draw_sw_simd_argb8888_to_xrgb8888(lv_draw_sw_blend_image_dsc_t * dsc, uint32_t dest_px_size);
+lv_result_t lv_draw_sw_simd_rgb565_to_xrgb8888(lv_draw_sw_blend_image_dsc_t * dsc, uint32_t dest_px_size);
+lv_result_t lv_draw_sw_simd_color_to_rgb565(lv_draw_sw_blend_fill_dsc_t * dsc);
+
+/**
+ * Convert pixels with the selected kernels.
+ * `xrgb8888_to_rgb565` truncates like `lv_color_to_u16`; `rgb565_to_xrgb8888`
+ * expands like LVGL's RGB565 image blending and sets the alpha byte to 0xFF.
+ */
+void lv_draw_sw_simd_xrgb8888_to_rgb565(const uint32_t * src, uint16_t * dest, uint32_t px_cnt);
+void lv_draw_sw_simd_rgb565_to_xrgb8888_buf(const uint16_t * src, uint32_t * dest, uint32_t px_cnt);
+
+/** Swap the bytes of RGB565 pixels in place for SPI panels, like `lv_draw_sw_rgb565_swap` */
+void lv_draw_sw_simd_rgb565_swap(void * buf, uint32_t px_cnt);
+
+/**********************
+ *      MACROS
+ **********************/
+
+/*XRGB8888 (and RGB888) destinations: lv_draw_sw_blend_to_rgb888.c*/
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB888(dsc, dest_px_size) \
+    lv_draw_sw_simd_color_to_xrgb8888(dsc, dest_px_size)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB888_WITH_OPA(dsc, dest_px_size) \
+    lv_draw_sw_simd_color_to_xrgb8888(dsc, dest_px_size)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB888_WITH_MASK(dsc, dest_px_size) \
+    lv_draw_sw_simd_color_to_xrgb8888(dsc, dest_px_size)
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB888_MIX_MASK_OPA(dsc, dest_px_size) \
+    lv_draw_sw_simd_color_to_xrgb8888(dsc, dest_px_size)
+
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB888(dsc, dest_px_size) \
+    lv_draw_sw_simd_argb8888_to_xrgb8888(dsc, dest_px_size)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB888_WITH_OPA(dsc, dest_px_size) \
+    lv_draw_sw_simd_argb8888_to_xrgb8888(dsc, dest_px_size)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB888_WITH_MASK(dsc, dest_px_size) \
+    lv_draw_sw_simd_argb8888_to_xrgb8888(dsc, dest_px_size)
+#define LV_DRAW_SW_ARGB8888_BLEND_NORMAL_TO_RGB888_MIX_MASK_OPA(dsc, dest_px_size) \
+    lv_draw_sw_simd_argb8888_to_xrgb8888(dsc, dest_px_size)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB888(dsc, dest_px_size) \
+    lv_draw_sw_simd_rgb565_to_xrgb8888(dsc, dest_px_size)
+
+/*RGB565 destination: lv_draw_sw_blend_to_rgb565.c*/
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc) \
+    lv_draw_sw_simd_color_to_rgb565(dsc)
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*LV_DRAW_SW_SIMD_H*/
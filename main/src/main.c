@@ -13,21 +13,40 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #ifdef _MSC_VER
   #include <Windows.h>
 #else
   #include <unistd.h>
   #include <pthread.h>
+  #include <signal.h>
 #endif
 
 #include "lvgl/lvgl.h"
 #include "lvgl/examples/lv_examples.h"
 #include "lvgl/demos/lv_demos.h"
 #include "../ui/my_ui.h" // 包含自定义UI头文件
+#include "main_wait.h"
+#include "frame_stats.h"
+#include "lcd_bus.h"
+#include "async_flush.h"
+#include "ram_report.h"
+#include "inv_stats.h"
+#include "render_cost.h"
+#include "../ui/system/trace.h"
 
 /*********************
  *      DEFINES
  *********************/
+#define TRACE_MAX_EVENTS    (1024 * 1024)
+
+/*Set by the LV_DEVICE_PROFILE CMake option: the target's partial buffers and SPI byte swap*/
+#ifndef DEVICE_BUF_DIVISOR
+  #define DEVICE_BUF_DIVISOR    0
+#endif
+#ifndef DEVICE_SWAP_BYTES
+  #define DEVICE_SWAP_BYTES     0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -37,10 +56,17 @@
  *  STATIC PROTOTYPES
  **********************/
 static lv_display_t * hal_init(int32_t w, int32_t h);
+static void frame_stats_dump_at_exit(void);
+static void trace_write_at_exit(void);
+#ifndef _MSC_VER
+static void frame_stats_signal_cb(int sig);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static const char * frame_stats_path;
+static const char * trace_path;
 
 /**********************
  *      MACROS
@@ -75,17 +101,98 @@ extern void freertos_main(void);
 
 int main(int argc, char **argv)
 {
-  (void)argc; /*Unused*/
-  (void)argv; /*Unused*/
+  /* --loop sleep:        the old loop, sleep until the next LVGL timer
+   * --loop-stats <s>:    print wake-ups, idle CPU and input latency every <s> seconds
+   * --latency-probe <ms>: inject a pointer move every <ms> to measure input-to-render latency
+   * --frame-stats <csv>: write the last frames' timing on exit and on SIGUSR1
+   * --trace <json>:      record LVGL profiler and app spans, write a Chrome trace on exit (-DLV_TRACE=ON builds)
+   * --lcd-mhz <f>:       emulate the device's SPI LCD bus in the flush path; tuned with
+   *   --lcd-bpp <n> (16), --lcd-dma-chunk <bytes> (4092) and --lcd-chunk-us <us> (2)
+   * --async-flush <n>:   double-buffered partial rendering, buffers of 1/<n> screen, flushed on a thread
+   *                      (on by default with the LV_DEVICE_PROFILE build, 0 turns it off)
+   * --inv-stats <csv>:   attribute the invalidated areas to widgets, report them with --loop-stats
+   *                      and on exit, log every area to <csv> ("-" for the report only)
+   * --inv-overlay:       tint the redrawn areas with a color changing every frame
+   * --render-cost <n>:   time every draw task per widget, print the top <n> with --loop-stats and on exit */
+  bool loop_sleep = false;
+  uint32_t stats_period_s = 0;
+  uint32_t probe_ms = 0;
+  lcd_bus_config_t lcd_cfg;
+  lcd_bus_config_init(&lcd_cfg);
+  double lcd_mhz = 0;
+  uint32_t async_divisor = DEVICE_BUF_DIVISOR;
+  const char * inv_stats_path = NULL;
+  bool inv_overlay = false;
+  uint32_t render_cost_top = 0;
+  for(int i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "--loop") == 0 && i + 1 < argc) loop_sleep = strcmp(argv[++i], "sleep") == 0;
+    else if(strcmp(argv[i], "--loop-stats") == 0 && i + 1 < argc) stats_period_s = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--latency-probe") == 0 && i + 1 < argc) probe_ms = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--frame-stats") == 0 && i + 1 < argc) frame_stats_path = argv[++i];
+    else if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_path = argv[++i];
+    else if(strcmp(argv[i], "--lcd-mhz") == 0 && i + 1 < argc) lcd_mhz = atof(argv[++i]);
+    else if(strcmp(argv[i], "--lcd-bpp") == 0 && i + 1 < argc) lcd_cfg.bits_per_pixel = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--lcd-dma-chunk") == 0 && i + 1 < argc) lcd_cfg.dma_chunk_bytes = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--lcd-chunk-us") == 0 && i + 1 < argc) lcd_cfg.chunk_overhead_us = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--async-flush") == 0 && i + 1 < argc) async_divisor = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--inv-stats") == 0 && i + 1 < argc) inv_stats_path = argv[++i];
+    else if(strcmp(argv[i], "--inv-overlay") == 0) inv_overlay = true;
+    else if(strcmp(argv[i], "--render-cost") == 0 && i + 1 < argc) render_cost_top = (uint32_t)atoi(argv[++i]);
+  }
+
+  if(trace_path) {
+    if(!LV_TRACE) fprintf(stderr, "--trace needs a build configured with -DLV_TRACE=ON\n");
+    else if(trace_start(TRACE_MAX_EVENTS)) atexit(trace_write_at_exit);
+    else fprintf(stderr, "Failed to allocate the trace buffer\n");
+  }
 
   /*Initialize LVGL*/
   lv_init();
 
   /*Initialize the HAL (display, input devices, tick) for LVGL*/
   //hal_init(800, 600);
-  hal_init(240, 320);
+  lv_display_t * disp = hal_init(240, 320);
+
+  /* Make the flush as slow as the device's panel; the report goes with --loop-stats and to the exit.
+   * With the async flush the bus is driven by the flush thread instead of the flush callback. */
+  if(lcd_mhz > 0) {
+    lcd_cfg.bus_hz = (uint32_t)(lcd_mhz * 1000000.0);
+    if(async_divisor) lcd_bus_configure(&lcd_cfg);
+    else lcd_bus_init(disp, &lcd_cfg);
+    atexit(lcd_bus_log_stats);
+  }
+  if(async_divisor) {
+    async_flush_config_t async_cfg = { async_divisor, main_wait_notify, DEVICE_SWAP_BYTES };
+    if(async_flush_init(disp, &async_cfg)) atexit(async_flush_log_stats);
+  }
+  ram_report_print(disp);
+
+  /* Per-frame timing, kept in a ring buffer and dumped on demand */
+  frame_stats_init(disp, my_ui_current_page);
+  if(frame_stats_path) {
+    atexit(frame_stats_dump_at_exit);
+#ifndef _MSC_VER
+    signal(SIGUSR1, frame_stats_signal_cb);
+#endif
+  }
+
+  /* Which widgets make the display redraw */
+  if(inv_stats_path || inv_overlay) {
+    inv_stats_init(disp, my_ui_current_page);
+    inv_stats_set_overlay(inv_overlay);
+    if(inv_stats_path && strcmp(inv_stats_path, "-") != 0 && !inv_stats_open_log(inv_stats_path)) {
+      fprintf(stderr, "Failed to open %s\n", inv_stats_path);
+    }
+    if(inv_stats_path) atexit(inv_stats_log_report);
+  }
+
+  /* Which widgets the render time goes to */
+  if(render_cost_top && render_cost_init(disp, my_ui_current_page, render_cost_top)) atexit(render_cost_log_report);
+
+  #if LV_USE_OS == LV_OS_NONE || LV_USE_OS == LV_OS_PTHREAD
 
-  #if LV_USE_OS == LV_OS_NONE
+  /* With LV_OS_PTHREAD (LV_MT_RENDER build) this thread still runs the UI; the
+   * extra threads only render. lv_timer_handler() and the my_ui_* functions take lv_lock. */
 
   /* Run the default demo */
   /* To try a different demo or example, replace this with one of: */
@@ -97,17 +204,36 @@ int main(int argc, char **argv)
   //lv_demo_benchmark();
   //lv_demo_stress();
   //lv_demo_music();
+  /* Background loaders (SD directory listing) wake the loop when they have results */
+  my_ui_set_wake_cb(main_wait_notify);
   my_ui_init();
+  main_wait_set_latency_probe(probe_ms);
+  uint32_t stats_tick = lv_tick_get();
   while(1) {
     /* Periodically call the lv_task handler.
      * It could be done in a timer interrupt or an OS task too.*/
+    frame_stats_loop_begin();
     uint32_t time_till_next = lv_timer_handler();
-    if(time_till_next == LV_NO_TIMER_READY) time_till_next = LV_DEF_REFR_PERIOD;
-#ifdef _MSC_VER
-    Sleep(5);
-#else
-    usleep(time_till_next*1000);
-#endif
+    frame_stats_loop_end();
+    /* Show the frame the flush thread has finished (it wakes main_wait) */
+    async_flush_present();
+    /* Use the idle gap to prefetch the page the user is likely to open next.
+     * If some work was done, run the timer handler again instead of sleeping. */
+    if(my_ui_idle(time_till_next == LV_NO_TIMER_READY ? LV_DEF_REFR_PERIOD : time_till_next)) continue;
+
+    if(stats_period_s && lv_tick_elaps(stats_tick) >= stats_period_s * 1000) {
+      main_wait_log_stats();
+      lcd_bus_log_stats();
+      async_flush_log_stats();
+      if(inv_stats_path) inv_stats_log_report();
+      render_cost_log_report();
+      my_ui_log_stats();
+      stats_tick = lv_tick_get();
+    }
+
+    /* Block until the next timer, an input event or a service notification */
+    if(loop_sleep) main_wait_sleep(time_till_next == LV_NO_TIMER_READY ? LV_DEF_REFR_PERIOD : time_till_next);
+    else main_wait(time_till_next == LV_NO_TIMER_READY ? MAIN_WAIT_FOREVER : time_till_next);
   }
 
   #elif LV_USE_OS == LV_OS_FREERTOS
@@ -124,6 +250,29 @@ int main(int argc, char **argv)
  *   STATIC FUNCTIONS
  **********************/
 
+static void frame_stats_dump_at_exit(void)
+{
+  int32_t cnt = frame_stats_dump_csv(frame_stats_path);
+  if(cnt < 0) fprintf(stderr, "Failed to write %s\n", frame_stats_path);
+  else printf("Frame stats: %d frames written to %s\n", (int)cnt, frame_stats_path);
+}
+
+static void trace_write_at_exit(void)
+{
+  int32_t cnt = trace_write_json(trace_path);
+  if(cnt < 0) fprintf(stderr, "Failed to write %s\n", trace_path);
+  else printf("Trace: %d events written to %s (%u dropped)\n", (int)cnt, trace_path, (unsigned)trace_dropped());
+}
+
+#ifndef _MSC_VER
+/* Only sets a flag; the main loop writes the file */
+static void frame_stats_signal_cb(int sig)
+{
+  (void)sig;
+  frame_stats_request_dump(frame_stats_path);
+}
+#endif
+
 /**
  * Initialize the Hardware Abstraction Layer (HAL) for the LVGL graphics
  * library
@@ -133,6 +282,8 @@ static lv_display_t * hal_init(int32_t w, int32_t h)
 
   lv_group_set_default(lv_group_create());
 
+  /* Timers created by the SDL driver are found by main_wait_init() */
+  main_wait_mark_timers();
   lv_display_t * disp = lv_sdl_window_create(w, h);
 
   lv_indev_t * mouse = lv_sdl_mouse_create();
@@ -154,5 +305,7 @@ static lv_display_t * hal_init(int32_t w, int32_t h)
   lv_indev_set_display(kb, disp);
   lv_indev_set_group(kb, lv_group_get_default());
 
+  main_wait_init(disp);
+
   return disp;
 }
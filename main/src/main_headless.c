@@ -0,0 +1,237 @@
+
+/**
+ * @file main_headless
+ * Runs the UI on the headless framebuffer backend (no SDL window, no event pump).
+ *
+ * Usage: main_headless [--duration ms] [--script file] [--flush-us us] [--flush-ns-px ns]
+ *                      [--virtual-time] [--dump file.ppm] [--frame-stats file.csv]
+ *                      [--trace file.json] [--lcd-mhz f [--lcd-bpp n] [--lcd-dma-chunk bytes]
+ *                      [--lcd-chunk-us us]] [--async-flush n] [--inv-stats file.csv|-] [--inv-overlay]
+ *                      [--render-cost n]
+ *
+ * --lcd-mhz emulates the SPI LCD bus (see lcd_bus.h); it waits in real time, so combine it
+ * with the real clock rather than --virtual-time. --async-flush renders into two partial
+ * buffers of 1/n screen each and flushes them on a thread (see async_flush.h); the
+ * LV_DEVICE_PROFILE build turns it on by default, --async-flush 0 turns it off.
+ * --inv-stats reports the widgets with the most invalidated pixels (see inv_stats.h) and logs
+ * every area to the file unless it is "-"; --inv-overlay tints the redrawn areas (see --dump).
+ * --render-cost prints the n widgets and classes with the most draw task time (see render_cost.h).
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifndef _DEFAULT_SOURCE
+  #define _DEFAULT_SOURCE /* needed for usleep() */
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lvgl/lvgl.h"
+#include "headless_display.h"
+#include "frame_stats.h"
+#include "lcd_bus.h"
+#include "async_flush.h"
+#include "ram_report.h"
+#include "inv_stats.h"
+#include "render_cost.h"
+#include "../ui/system/trace.h"
+#include "../ui/my_ui.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_DURATION_MS     5000
+#define TRACE_MAX_EVENTS        (1024 * 1024)
+
+/*Set by the LV_DEVICE_PROFILE CMake option: the target's partial buffers and SPI byte swap*/
+#ifndef DEVICE_BUF_DIVISOR
+  #define DEVICE_BUF_DIVISOR    0
+#endif
+#ifndef DEVICE_SWAP_BYTES
+  #define DEVICE_SWAP_BYTES     0
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint64_t wall_us(void);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char **argv)
+{
+  uint32_t duration_ms = DEFAULT_DURATION_MS;
+  const char * script = NULL;
+  const char * dump = NULL;
+  const char * frame_stats_path = NULL;
+  const char * trace_path = NULL;
+  uint32_t flush_us = 0;
+  uint32_t flush_ns_px = 0;
+  bool virtual_time = false;
+  lcd_bus_config_t lcd_cfg;
+  lcd_bus_config_init(&lcd_cfg);
+  double lcd_mhz = 0;
+  uint32_t async_divisor = DEVICE_BUF_DIVISOR;
+  const char * inv_stats_path = NULL;
+  bool inv_overlay = false;
+  uint32_t render_cost_top = 0;
+
+  for(int i = 1; i < argc; i++) {
+    if(strcmp(argv[i], "--duration") == 0 && i + 1 < argc) duration_ms = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--script") == 0 && i + 1 < argc) script = argv[++i];
+    else if(strcmp(argv[i], "--flush-us") == 0 && i + 1 < argc) flush_us = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--flush-ns-px") == 0 && i + 1 < argc) flush_ns_px = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--virtual-time") == 0) virtual_time = true;
+    else if(strcmp(argv[i], "--dump") == 0 && i + 1 < argc) dump = argv[++i];
+    else if(strcmp(argv[i], "--frame-stats") == 0 && i + 1 < argc) frame_stats_path = argv[++i];
+    else if(strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace_path = argv[++i];
+    else if(strcmp(argv[i], "--lcd-mhz") == 0 && i + 1 < argc) lcd_mhz = atof(argv[++i]);
+    else if(strcmp(argv[i], "--lcd-bpp") == 0 && i + 1 < argc) lcd_cfg.bits_per_pixel = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--lcd-dma-chunk") == 0 && i + 1 < argc) lcd_cfg.dma_chunk_bytes = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--lcd-chunk-us") == 0 && i + 1 < argc) lcd_cfg.chunk_overhead_us = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--async-flush") == 0 && i + 1 < argc) async_divisor = (uint32_t)atoi(argv[++i]);
+    else if(strcmp(argv[i], "--inv-stats") == 0 && i + 1 < argc) inv_stats_path = argv[++i];
+    else if(strcmp(argv[i], "--inv-overlay") == 0) inv_overlay = true;
+    else if(strcmp(argv[i], "--render-cost") == 0 && i + 1 < argc) render_cost_top = (uint32_t)atoi(argv[++i]);
+    else {
+      fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+      return 1;
+    }
+  }
+
+  if(trace_path && !LV_TRACE) {
+    fprintf(stderr, "--trace needs a build configured with -DLV_TRACE=ON\n");
+    return 1;
+  }
+  if(trace_path && !trace_start(TRACE_MAX_EVENTS)) {
+    fprintf(stderr, "Failed to allocate the trace buffer\n");
+    return 1;
+  }
+
+  /*Initialize LVGL*/
+  lv_init();
+
+  /*Same resolution as the SDL build*/
+  lv_display_t * disp = headless_display_create(240, 320);
+  if(disp == NULL) {
+    fprintf(stderr, "Failed to create the headless display\n");
+    return 1;
+  }
+  headless_display_set_flush_cost(flush_us, flush_ns_px);
+  headless_tick_set_virtual(virtual_time);
+  if(lcd_mhz > 0) {
+    lcd_cfg.bus_hz = (uint32_t)(lcd_mhz * 1000000.0);
+    if(async_divisor) lcd_bus_configure(&lcd_cfg);
+    else lcd_bus_init(disp, &lcd_cfg);
+  }
+  if(async_divisor) {
+    async_flush_config_t async_cfg = { async_divisor, NULL, DEVICE_SWAP_BYTES };
+    if(!async_flush_init(disp, &async_cfg)) return 1;
+  }
+  ram_report_print(disp);
+
+  lv_group_set_default(lv_group_create());
+  lv_indev_t * pointer = headless_input_create(disp);
+  lv_indev_set_group(pointer, lv_group_get_default());
+
+  if(script && headless_input_load_script(script) < 0) {
+    fprintf(stderr, "Failed to open script: %s\n", script);
+    return 1;
+  }
+
+  if(inv_stats_path || inv_overlay) {
+    inv_stats_init(disp, my_ui_current_page);
+    inv_stats_set_overlay(inv_overlay);
+    if(inv_stats_path && strcmp(inv_stats_path, "-") != 0 && !inv_stats_open_log(inv_stats_path)) {
+      fprintf(stderr, "Failed to open %s\n", inv_stats_path);
+      return 1;
+    }
+  }
+
+  if(render_cost_top && !render_cost_init(disp, my_ui_current_page, render_cost_top)) return 1;
+
+  my_ui_init();
+  frame_stats_init(disp, my_ui_current_page);
+
+  uint64_t start = wall_us();
+  uint32_t start_tick = lv_tick_get();
+  uint32_t loops = 0;
+
+  /*Run until the duration has passed and the script has been played*/
+  while(lv_tick_elaps(start_tick) < duration_ms || !headless_input_done()) {
+    frame_stats_loop_begin();
+    uint32_t time_till_next = lv_timer_handler();
+    frame_stats_loop_end();
+    async_flush_present();
+    if(time_till_next == LV_NO_TIMER_READY) time_till_next = LV_DEF_REFR_PERIOD;
+    loops++;
+    if(my_ui_idle(time_till_next)) continue;
+
+    /*With virtual time, jump straight to the next timer instead of sleeping*/
+    if(virtual_time) headless_tick_advance(time_till_next ? time_till_next : 1);
+    else usleep(time_till_next * 1000);
+  }
+
+  /*The framebuffer checksum needs the last frame*/
+  async_flush_sync();
+  uint64_t elapsed = wall_us() - start;
+  headless_display_stats_t stats;
+  headless_display_get_stats(&stats);
+
+  printf("Headless run: %u ms UI time, %.1f ms wall time, %u loops\n",
+         (unsigned)lv_tick_elaps(start_tick), elapsed / 1000.0, (unsigned)loops);
+  printf("Flush: %u calls, %llu px, %.1f ms total\n",
+         (unsigned)stats.flush_count, (unsigned long long)stats.flushed_px, stats.flush_time_us / 1000.0);
+  lcd_bus_log_stats();
+  async_flush_log_stats();
+  if(inv_stats_path) {
+    inv_stats_log_report();
+    inv_stats_close_log();
+  }
+  render_cost_log_report();
+  my_ui_log_stats();
+  printf("Framebuffer checksum: %08x\n", (unsigned)headless_display_checksum());
+
+  if(frame_stats_path) {
+    int32_t cnt = frame_stats_dump_csv(frame_stats_path);
+    if(cnt < 0) {
+      fprintf(stderr, "Failed to write %s\n", frame_stats_path);
+      return 1;
+    }
+    printf("Frame stats: %d frames written to %s\n", (int)cnt, frame_stats_path);
+  }
+
+  if(trace_path) {
+    int32_t cnt = trace_write_json(trace_path);
+    if(cnt < 0) {
+      fprintf(stderr, "Failed to write %s\n", trace_path);
+      return 1;
+    }
+    printf("Trace: %d events written to %s (%u dropped)\n", (int)cnt, trace_path, (unsigned)trace_dropped());
+  }
+
+  if(dump && !headless_display_save_ppm(dump)) {
+    fprintf(stderr, "Failed to write %s\n", dump);
+    return 1;
+  }
+
+  return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint64_t wall_us(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + ts.tv_nsec / 1000;
+}
@@ -0,0 +1,444 @@
+/**
+ * @file main_wait.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifndef _DEFAULT_SOURCE
+  #define _DEFAULT_SOURCE /* needed for usleep() */
+#endif
+
+#include "main_wait.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <unistd.h>
+  #include <sys/resource.h>
+#endif
+
+#if LV_USE_SDL
+  #include LV_SDL_INCLUDE_PATH
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MARK_MAX_TIMERS         64
+#define POLL_MAX_TIMERS         8
+#define LATENCY_SAMPLES         256
+
+/*Slow down the SDL and input polling after this much time without input*/
+#define IDLE_RELAX_MS           1000
+/*Polling period while relaxed; input wakes the loop immediately anyway*/
+#define IDLE_POLL_MS            250
+/*Inputs not followed by a rendered frame within this time did not change the screen*/
+#define LATENCY_MAX_VALID_US    500000
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_timer_t * timer;
+    uint32_t period;            /*Original period*/
+} poll_timer_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint64_t now_us(void);
+static uint64_t cpu_time_us(void);
+static bool timer_was_marked(lv_timer_t * timer);
+static bool input_busy(void);
+static void relax_polling(void);
+static void restore_polling(void);
+static void latency_add(uint32_t us);
+static void render_ready_cb(lv_event_t * e);
+#if LV_USE_SDL
+static bool is_input_event(uint32_t type);
+static int SDLCALL event_watch_cb(void * userdata, SDL_Event * event);
+static int SDLCALL probe_thread_cb(void * data);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_timer_t * marked_timers[MARK_MAX_TIMERS];
+static uint32_t marked_cnt;
+
+/*SDL event polling timers of the driver and the input device read timers*/
+static poll_timer_t poll_timers[POLL_MAX_TIMERS];
+static uint32_t poll_cnt;
+static uint32_t sdl_poll_cnt;
+static bool relaxed;
+static uint32_t last_input_tick;
+
+static lv_display_t * wait_disp;
+static main_wait_stats_t stats;
+static uint64_t stats_start_us;
+static uint64_t stats_start_cpu_us;
+
+static uint32_t latency[LATENCY_SAMPLES];
+static uint32_t latency_pos;
+static uint64_t latency_sum;
+
+#if LV_USE_SDL
+static uint32_t wake_event_type;
+static SDL_atomic_t notify_pending;
+static SDL_SpinLock input_lock;
+static uint64_t input_pending_us;       /*Arrival of the oldest input not rendered yet*/
+static SDL_Thread * probe_thread;
+static SDL_atomic_t probe_period;
+static uint32_t probe_window_id;
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void main_wait_mark_timers(void)
+{
+    marked_cnt = 0;
+    for(lv_timer_t * t = lv_timer_get_next(NULL); t && marked_cnt < MARK_MAX_TIMERS; t = lv_timer_get_next(t)) {
+        marked_timers[marked_cnt++] = t;
+    }
+}
+
+void main_wait_init(lv_display_t * disp)
+{
+    wait_disp = disp;
+    poll_cnt = 0;
+
+    /*Timers created by `lv_sdl_window_create` except the refresh timer belong to the SDL driver*/
+    lv_timer_t * refr_timer = lv_display_get_refr_timer(disp);
+    for(lv_timer_t * t = lv_timer_get_next(NULL); t && poll_cnt < POLL_MAX_TIMERS; t = lv_timer_get_next(t)) {
+        if(t == refr_timer || timer_was_marked(t)) continue;
+        bool is_indev = false;
+        for(lv_indev_t * indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+            if(lv_indev_get_read_timer(indev) == t) is_indev = true;
+        }
+        if(is_indev) continue;
+        poll_timers[poll_cnt].timer = t;
+        poll_timers[poll_cnt].period = lv_timer_get_period(t);
+        poll_cnt++;
+    }
+    sdl_poll_cnt = poll_cnt;
+
+    for(lv_indev_t * indev = lv_indev_get_next(NULL); indev && poll_cnt < POLL_MAX_TIMERS;
+        indev = lv_indev_get_next(indev)) {
+        lv_timer_t * t = lv_indev_get_read_timer(indev);
+        if(t == NULL) continue;
+        poll_timers[poll_cnt].timer = t;
+        poll_timers[poll_cnt].period = lv_timer_get_period(t);
+        poll_cnt++;
+    }
+
+    if(sdl_poll_cnt == 0) {
+        LV_LOG_WARN("SDL event timer not found, main_wait falls back to sleeping");
+    }
+
+    lv_display_add_event_cb(disp, render_ready_cb, LV_EVENT_RENDER_READY, NULL);
+
+#if LV_USE_SDL
+    wake_event_type = SDL_RegisterEvents(1);
+    SDL_AddEventWatch(event_watch_cb, NULL);
+    SDL_Window * window = SDL_RenderGetWindow((SDL_Renderer *)lv_sdl_window_get_renderer(disp));
+    probe_window_id = window ? SDL_GetWindowID(window) : 0;
+#endif
+
+    last_input_tick = lv_tick_get();
+    main_wait_reset_stats();
+}
+
+main_wait_reason_t main_wait(uint32_t timeout_ms)
+{
+#if LV_USE_SDL
+    if(wait_disp == NULL || sdl_poll_cnt == 0 || wake_event_type == (uint32_t) -1) {
+        main_wait_sleep(timeout_ms == MAIN_WAIT_FOREVER ? LV_DEF_REFR_PERIOD : timeout_ms);
+        return MAIN_WAIT_TIMEOUT;
+    }
+
+    lv_lock();
+    if(!relaxed && lv_tick_elaps(last_input_tick) >= IDLE_RELAX_MS && !input_busy()) relax_polling();
+    lv_unlock();
+
+    uint64_t start = now_us();
+    int timeout = timeout_ms == MAIN_WAIT_FOREVER ? -1 : (int)LV_MIN(timeout_ms, (uint32_t)INT32_MAX);
+    int pending = timeout == 0 ? SDL_PollEvent(NULL) : SDL_WaitEventTimeout(NULL, timeout);
+    stats.idle_us += now_us() - start;
+    stats.loops++;
+
+    if(!pending) {
+        stats.wake_timeout++;
+        return MAIN_WAIT_TIMEOUT;
+    }
+
+    /*The events stay in the queue: let the driver's timer read them in the next `lv_timer_handler`*/
+    lv_lock();
+    for(uint32_t i = 0; i < sdl_poll_cnt; i++) lv_timer_ready(poll_timers[i].timer);
+
+    bool notified = SDL_AtomicSet(&notify_pending, 0) != 0;
+    if(SDL_HasEvents(SDL_FIRSTEVENT, SDL_USEREVENT - 1)) {
+        last_input_tick = lv_tick_get();
+        if(relaxed) restore_polling();
+        for(uint32_t i = sdl_poll_cnt; i < poll_cnt; i++) lv_timer_ready(poll_timers[i].timer);
+        lv_unlock();
+        stats.wake_input++;
+        return MAIN_WAIT_INPUT;
+    }
+    lv_unlock();
+
+    if(notified) {
+        stats.wake_notify++;
+        return MAIN_WAIT_NOTIFY;
+    }
+
+    /*Another user event*/
+    stats.wake_input++;
+    return MAIN_WAIT_INPUT;
+#else
+    main_wait_sleep(timeout_ms == MAIN_WAIT_FOREVER ? LV_DEF_REFR_PERIOD : timeout_ms);
+    return MAIN_WAIT_TIMEOUT;
+#endif
+}
+
+void main_wait_sleep(uint32_t timeout_ms)
+{
+    uint64_t start = now_us();
+#ifdef _WIN32
+    Sleep(timeout_ms);
+#else
+    usleep(timeout_ms * 1000);
+#endif
+    stats.idle_us += now_us() - start;
+    stats.loops++;
+    stats.wake_timeout++;
+}
+
+void main_wait_notify(void)
+{
+#if LV_USE_SDL
+    if(wake_event_type == 0 || wake_event_type == (uint32_t) -1) return;
+    /*One wake-up event in the queue is enough*/
+    if(SDL_AtomicSet(&notify_pending, 1) != 0) return;
+
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = wake_event_type;
+    SDL_PushEvent(&event);
+#endif
+}
+
+void main_wait_set_latency_probe(uint32_t period_ms)
+{
+#if LV_USE_SDL
+    SDL_AtomicSet(&probe_period, (int)period_ms);
+    if(period_ms && probe_thread == NULL) {
+        probe_thread = SDL_CreateThread(probe_thread_cb, "latency_probe", NULL);
+        if(probe_thread == NULL) LV_LOG_WARN("Failed to start the latency probe: %s", SDL_GetError());
+    }
+    else if(period_ms == 0 && probe_thread) {
+        SDL_WaitThread(probe_thread, NULL);
+        probe_thread = NULL;
+    }
+#else
+    LV_UNUSED(period_ms);
+#endif
+}
+
+void main_wait_get_stats(main_wait_stats_t * out)
+{
+    *out = stats;
+    out->wall_us = now_us() - stats_start_us;
+    uint64_t cpu = cpu_time_us();
+    out->cpu_us = cpu ? cpu - stats_start_cpu_us : 0;
+
+    uint32_t cnt = LV_MIN(stats.latency_count, (uint32_t)LATENCY_SAMPLES);
+    if(cnt == 0) return;
+
+    uint32_t sorted[LATENCY_SAMPLES];
+    memcpy(sorted, latency, cnt * sizeof(uint32_t));
+    /*Insertion sort, the buffer is small*/
+    for(uint32_t i = 1; i < cnt; i++) {
+        uint32_t v = sorted[i];
+        uint32_t j = i;
+        while(j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    out->latency_avg_us = (uint32_t)(latency_sum / stats.latency_count);
+    out->latency_p95_us = sorted[LV_MIN(cnt - 1, cnt * 95 / 100)];
+}
+
+void main_wait_reset_stats(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    latency_pos = 0;
+    latency_sum = 0;
+    stats_start_us = now_us();
+    stats_start_cpu_us = cpu_time_us();
+}
+
+void main_wait_log_stats(void)
+{
+    main_wait_stats_t s;
+    main_wait_get_stats(&s);
+    double wall_s = s.wall_us / 1000000.0;
+    if(wall_s <= 0) return;
+
+    printf("Main loop: %.1f wake-ups/s (timeout %u, input %u, notify %u), idle %.1f%%, CPU %.1f%%\n",
+           s.loops / wall_s, (unsigned)s.wake_timeout, (unsigned)s.wake_input, (unsigned)s.wake_notify,
+           s.idle_us * 100.0 / s.wall_us, s.cpu_us * 100.0 / s.wall_us);
+    if(s.latency_count) {
+        printf("Input to render: %u samples, avg %.2f ms, p95 %.2f ms, max %.2f ms\n",
+               (unsigned)s.latency_count, s.latency_avg_us / 1000.0, s.latency_p95_us / 1000.0,
+               s.latency_max_us / 1000.0);
+    }
+    main_wait_reset_stats();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint64_t now_us(void)
+{
+#if LV_USE_SDL
+    /*Split to avoid overflowing 64 bits with nanosecond counters*/
+    uint64_t cnt = SDL_GetPerformanceCounter();
+    uint64_t freq = SDL_GetPerformanceFrequency();
+    return cnt / freq * 1000000u + cnt % freq * 1000000u / freq;
+#else
+    return (uint64_t)lv_tick_get() * 1000;
+#endif
+}
+
+static uint64_t cpu_time_us(void)
+{
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage ru;
+    if(getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+    return (uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000u +
+           ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+#endif
+}
+
+static bool timer_was_marked(lv_timer_t * timer)
+{
+    for(uint32_t i = 0; i < marked_cnt; i++) {
+        if(marked_timers[i] == timer) return true;
+    }
+    return false;
+}
+
+/*Long press detection and scroll throw need the read timers even without new events*/
+static bool input_busy(void)
+{
+    for(lv_indev_t * indev = lv_indev_get_next(NULL); indev; indev = lv_indev_get_next(indev)) {
+        if(lv_indev_get_state(indev) == LV_INDEV_STATE_PRESSED) return true;
+        if(lv_indev_get_scroll_obj(indev)) return true;
+    }
+    return false;
+}
+
+static void relax_polling(void)
+{
+    for(uint32_t i = 0; i < poll_cnt; i++) {
+        if(poll_timers[i].period < IDLE_POLL_MS) lv_timer_set_period(poll_timers[i].timer, IDLE_POLL_MS);
+    }
+    relaxed = true;
+}
+
+static void restore_polling(void)
+{
+    for(uint32_t i = 0; i < poll_cnt; i++) {
+        lv_timer_set_period(poll_timers[i].timer, poll_timers[i].period);
+    }
+    relaxed = false;
+}
+
+static void latency_add(uint32_t us)
+{
+    latency[latency_pos] = us;
+    latency_pos = (latency_pos + 1) % LATENCY_SAMPLES;
+    latency_sum += us;
+    stats.latency_count++;
+    if(us > stats.latency_max_us) stats.latency_max_us = us;
+}
+
+static void render_ready_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+#if LV_USE_SDL
+    SDL_AtomicLock(&input_lock);
+    uint64_t arrived = input_pending_us;
+    input_pending_us = 0;
+    SDL_AtomicUnlock(&input_lock);
+
+    if(arrived == 0) return;
+    uint64_t us = now_us() - arrived;
+    if(us < LATENCY_MAX_VALID_US) latency_add((uint32_t)us);
+#endif
+}
+
+#if LV_USE_SDL
+
+static bool is_input_event(uint32_t type)
+{
+    switch(type) {
+        case SDL_MOUSEMOTION:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+        case SDL_MOUSEWHEEL:
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+        case SDL_TEXTINPUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*Called in the thread that adds the event to the queue*/
+static int SDLCALL event_watch_cb(void * userdata, SDL_Event * event)
+{
+    LV_UNUSED(userdata);
+    if(!is_input_event(event->type)) return 0;
+
+    SDL_AtomicLock(&input_lock);
+    if(input_pending_us == 0) input_pending_us = now_us();
+    SDL_AtomicUnlock(&input_lock);
+    return 0;
+}
+
+/*Wiggle the pointer by one pixel in the top left corner; the cursor image makes every move visible*/
+static int SDLCALL probe_thread_cb(void * data)
+{
+    LV_UNUSED(data);
+    int32_t x = 1;
+    int period;
+    while((period = SDL_AtomicGet(&probe_period)) > 0) {
+        SDL_Delay((uint32_t)period);
+
+        SDL_Event event;
+        SDL_zero(event);
+        event.type = SDL_MOUSEMOTION;
+        event.motion.windowID = probe_window_id;
+        event.motion.x = x;
+        event.motion.y = 1;
+        event.motion.xrel = x == 1 ? -1 : 1;
+        SDL_PushEvent(&event);
+        x = x == 1 ? 2 : 1;
+    }
+    return 0;
+}
+
+#endif /*LV_USE_SDL*/
@@ -0,0 +1,106 @@
+/**
+ * @file main_wait.h
+ * Event-driven wait for the main loop. Instead of sleeping for the time until
+ * the next LVGL timer, the loop blocks until that deadline, an SDL input event
+ * or a wake-up posted with `main_wait_notify` (from any thread).
+ */
+
+#ifndef MAIN_WAIT_H
+#define MAIN_WAIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/** Timeout value to block until input or a notification arrives */
+#define MAIN_WAIT_FOREVER   UINT32_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    MAIN_WAIT_TIMEOUT,          /*The deadline passed*/
+    MAIN_WAIT_INPUT,            /*An SDL event is pending*/
+    MAIN_WAIT_NOTIFY,           /*Woken by `main_wait_notify`*/
+} main_wait_reason_t;
+
+typedef struct {
+    uint32_t loops;             /*Main loop iterations (calls to `main_wait` or `main_wait_sleep`)*/
+    uint32_t wake_timeout;
+    uint32_t wake_input;
+    uint32_t wake_notify;
+    uint64_t wall_us;           /*Time since the stats were reset*/
+    uint64_t idle_us;           /*Time spent blocked*/
+    uint64_t cpu_us;            /*Process CPU time (user + system), 0 if not available*/
+    uint32_t latency_count;     /*Input events followed by a rendered frame*/
+    uint32_t latency_avg_us;
+    uint32_t latency_p95_us;
+    uint32_t latency_max_us;
+} main_wait_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Remember the existing LVGL timers. Call right before creating the SDL window
+ * so `main_wait_init` can find the SDL driver's event polling timer.
+ */
+void main_wait_mark_timers(void);
+
+/**
+ * Set up the wait primitive for a display created with `lv_sdl_window_create`.
+ * The SDL polling and input read timers are made ready as soon as an input
+ * event arrives, and slowed down while there is no input.
+ * @param disp  the SDL display
+ */
+void main_wait_init(lv_display_t * disp);
+
+/**
+ * Block until `timeout_ms` passes, an SDL event is pending or `main_wait_notify` is called.
+ * @param timeout_ms    time until the next LVGL timer, or `MAIN_WAIT_FOREVER`
+ * @return              the reason of the wake-up
+ */
+main_wait_reason_t main_wait(uint32_t timeout_ms);
+
+/**
+ * The old behavior (sleep for `timeout_ms`), kept for comparing the statistics.
+ */
+void main_wait_sleep(uint32_t timeout_ms);
+
+/**
+ * Wake up the main loop, e.g. when a service has posted new data.
+ * Can be called from any thread.
+ */
+void main_wait_notify(void);
+
+/**
+ * Push a synthetic mouse motion every `period_ms` from a helper thread to measure
+ * input-to-render latency independently of when the main loop looks at the queue.
+ * @param period_ms     probe period, 0 to stop
+ */
+void main_wait_set_latency_probe(uint32_t period_ms);
+
+void main_wait_get_stats(main_wait_stats_t * stats);
+
+void main_wait_reset_stats(void);
+
+/** Print the statistics since the last reset and reset them */
+void main_wait_log_stats(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*MAIN_WAIT_H*/
@@ -0,0 +1,267 @@
+
+/**
+ * @file page_bench
+ * Page navigation benchmark on the headless backend.
+ *
+ * Registers the pages through my_ui_init(), then for every page repeats
+ * gotoPage() + first frame + back() and records:
+ *   - build time: gotoPage() with caching and incremental building disabled
+ *   - first frame time: lv_refr_now() right after the page was loaded
+ *   - LVGL heap delta while the page is open, and the heap left after it was destroyed
+ *   - objects created by the page, and objects left after it was destroyed
+ *
+ * Usage: page_bench [--iterations n] [--format json|csv] [--out file] [--flush-us us]
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "lvgl/lvgl.h"
+#include "lvgl/src/display/lv_display_private.h"   /*screen list, for leak counting*/
+#include "headless_display.h"
+#include "../ui/my_ui.h"
+#include "page_manager.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_ITERATIONS      1000
+#define STARTUP_TIMEOUT_MS      10000
+#define ROOT_PAGE               "page_menu"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+struct PageResult {
+    std::string name;
+    std::vector<uint32_t> build_us;
+    std::vector<uint32_t> render_us;
+    int64_t heap_delta_sum = 0;         /*Heap growth while the page is open*/
+    int64_t heap_leak = 0;              /*Heap growth over all iterations after destroy*/
+    uint32_t objects = 0;               /*Objects in the page (last iteration)*/
+    int64_t objects_leaked = 0;         /*Objects left behind over all iterations*/
+};
+
+struct Summary {
+    uint32_t min, max, mean, p50, p95;
+};
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern PageManager g_pageManager;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t elapsed_us(std::chrono::steady_clock::time_point start);
+static int64_t heap_used(void);
+static uint32_t count_objects(lv_obj_t * obj);
+static uint32_t count_all_objects(lv_display_t * disp);
+static void pump(uint32_t ms);
+static Summary summarize(std::vector<uint32_t> v);
+static void write_json(FILE * f, const std::vector<PageResult> & results, uint32_t iterations);
+static void write_csv(FILE * f, const std::vector<PageResult> & results, uint32_t iterations);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char ** argv)
+{
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    const char * format = "json";
+    const char * out_path = NULL;
+    uint32_t flush_us = 0;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) iterations = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "--format") == 0 && i + 1 < argc) format = argv[++i];
+        else if(strcmp(argv[i], "--out") == 0 && i + 1 < argc) out_path = argv[++i];
+        else if(strcmp(argv[i], "--flush-us") == 0 && i + 1 < argc) flush_us = (uint32_t)atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if(iterations == 0) iterations = 1;
+
+    lv_init();
+    lv_display_t * disp = headless_display_create(240, 320);
+    if(disp == NULL) {
+        fprintf(stderr, "Failed to create the headless display\n");
+        return 1;
+    }
+    headless_display_set_flush_cost(flush_us, 0);
+    headless_tick_set_virtual(true);
+
+    my_ui_init();
+
+    /*Let the startup page hand over to the menu*/
+    for(uint32_t t = 0; t < STARTUP_TIMEOUT_MS && g_pageManager.currentPage() != ROOT_PAGE; t += LV_DEF_REFR_PERIOD) {
+        pump(LV_DEF_REFR_PERIOD);
+    }
+    if(g_pageManager.currentPage() != ROOT_PAGE) g_pageManager.gotoPageAndDestroy(ROOT_PAGE);
+    pump(1000);
+    g_pageManager.flushTeardown();
+
+    /*Measure the factories: every visit builds the page synchronously*/
+    g_pageManager.setCacheBudget(0);
+    g_pageManager.setBuildBudget(0);
+    g_pageManager.setMemoryPressure(101, 100);
+
+    std::vector<PageResult> results;
+    for(const std::string & name : g_pageManager.pageNames()) {
+        if(name == ROOT_PAGE || name == "pre_page") continue;
+
+        PageResult res;
+        res.name = name;
+        res.build_us.reserve(iterations);
+        res.render_us.reserve(iterations);
+
+        int64_t heap_start = heap_used();
+        int64_t objects_start = count_all_objects(disp);
+
+        for(uint32_t i = 0; i < iterations; i++) {
+            int64_t heap_before = heap_used();
+
+            auto t0 = std::chrono::steady_clock::now();
+            g_pageManager.gotoPage(name);
+            res.build_us.push_back(elapsed_us(t0));
+
+            auto t1 = std::chrono::steady_clock::now();
+            lv_refr_now(disp);
+            res.render_us.push_back(elapsed_us(t1));
+
+            res.heap_delta_sum += heap_used() - heap_before;
+            res.objects = count_objects(lv_screen_active());
+
+            g_pageManager.back();
+            g_pageManager.flushTeardown();
+            /*Run pending async calls and timers of the destroyed page*/
+            lv_timer_handler();
+        }
+
+        res.heap_leak = heap_used() - heap_start;
+        res.objects_leaked = (int64_t)count_all_objects(disp) - objects_start;
+        fprintf(stderr, "%-16s done\n", name.c_str());
+        results.push_back(std::move(res));
+    }
+
+    FILE * out = stdout;
+    if(out_path) {
+        out = fopen(out_path, "w");
+        if(out == NULL) {
+            fprintf(stderr, "Failed to open %s\n", out_path);
+            return 1;
+        }
+    }
+    if(strcmp(format, "csv") == 0) write_csv(out, results, iterations);
+    else write_json(out, results, iterations);
+    if(out != stdout) fclose(out);
+
+    return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static uint32_t elapsed_us(std::chrono::steady_clock::time_point start)
+{
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start).count();
+}
+
+static int64_t heap_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return (int64_t)(mon.total_size - mon.free_size);
+}
+
+static uint32_t count_objects(lv_obj_t * obj)
+{
+    uint32_t n = 1;
+    uint32_t cnt = lv_obj_get_child_count(obj);
+    for(uint32_t i = 0; i < cnt; i++) n += count_objects(lv_obj_get_child(obj, (int32_t)i));
+    return n;
+}
+
+/*All screens and layers of the display, including cached and hidden ones*/
+static uint32_t count_all_objects(lv_display_t * disp)
+{
+    uint32_t n = 0;
+    for(uint32_t i = 0; i < disp->screen_cnt; i++) n += count_objects(disp->screens[i]);
+    n += count_objects(lv_display_get_layer_top(disp));
+    n += count_objects(lv_display_get_layer_sys(disp));
+    return n;
+}
+
+/*Advance the virtual clock and run the timers*/
+static void pump(uint32_t ms)
+{
+    for(uint32_t t = 0; t < ms; t += LV_DEF_REFR_PERIOD) {
+        headless_tick_advance(LV_DEF_REFR_PERIOD);
+        lv_timer_handler();
+    }
+}
+
+static Summary summarize(std::vector<uint32_t> v)
+{
+    Summary s = {0, 0, 0, 0, 0};
+    if(v.empty()) return s;
+    std::sort(v.begin(), v.end());
+    uint64_t sum = 0;
+    for(uint32_t x : v) sum += x;
+    s.min = v.front();
+    s.max = v.back();
+    s.mean = (uint32_t)(sum / v.size());
+    s.p50 = v[v.size() / 2];
+    s.p95 = v[std::min(v.size() - 1, v.size() * 95 / 100)];
+    return s;
+}
+
+static void write_json(FILE * f, const std::vector<PageResult> & results, uint32_t iterations)
+{
+    fprintf(f, "{\n  \"iterations\": %u,\n  \"pages\": [\n", (unsigned)iterations);
+    for(size_t i = 0; i < results.size(); i++) {
+        const PageResult & r = results[i];
+        Summary b = summarize(r.build_us);
+        Summary d = summarize(r.render_us);
+        fprintf(f, "    {\"name\": \"%s\", "
+                "\"build_us\": {\"mean\": %u, \"p50\": %u, \"p95\": %u, \"min\": %u, \"max\": %u}, "
+                "\"first_frame_us\": {\"mean\": %u, \"p50\": %u, \"p95\": %u, \"min\": %u, \"max\": %u}, "
+                "\"heap_delta_bytes\": %lld, \"heap_leaked_bytes\": %lld, "
+                "\"objects\": %u, \"objects_leaked\": %lld}%s\n",
+                r.name.c_str(),
+                b.mean, b.p50, b.p95, b.min, b.max,
+                d.mean, d.p50, d.p95, d.min, d.max,
+                (long long)(r.heap_delta_sum / iterations), (long long)r.heap_leak,
+                (unsigned)r.objects, (long long)r.objects_leaked,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+static void write_csv(FILE * f, const std::vector<PageResult> & results, uint32_t iterations)
+{
+    fprintf(f, "page,build_mean_us,build_p95_us,build_max_us,first_frame_mean_us,first_frame_p95_us,"
+            "first_frame_max_us,heap_delta_bytes,heap_leaked_bytes,objects,objects_leaked\n");
+    for(const PageResult & r : results) {
+        Summary b = summarize(r.build_us);
+        Summary d = summarize(r.render_us);
+        fprintf(f, "%s,%u,%u,%u,%u,%u,%u,%lld,%lld,%u,%lld\n",
+                r.name.c_str(), b.mean, b.p95, b.max, d.mean, d.p95, d.max,
+                (long long)(r.heap_delta_sum / iterations), (long long)r.heap_leak,
+                (unsigned)r.objects, (long long)r.objects_leaked);
+    }
+}
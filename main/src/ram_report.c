@@ -0,0 +1,67 @@
+/**
+ * @file ram_report.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "ram_report.h"
+#include "lvgl/src/display/lv_display_private.h"
+#include <stdio.h>
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const char * cf_name(lv_color_format_t cf);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+void ram_report_print(lv_display_t * disp)
+{
+    lv_draw_buf_t * bufs[2] = { disp->buf_1, disp->buf_2 };
+    uint32_t buf_cnt = 0;
+    uint32_t buf_bytes = 0;
+    uint32_t lines = 0;
+    for(uint32_t i = 0; i < 2; i++) {
+        if(bufs[i] == NULL || bufs[i]->data == NULL) continue;
+        buf_cnt++;
+        buf_bytes += bufs[i]->data_size;
+        if(bufs[i]->header.stride) lines = bufs[i]->data_size / bufs[i]->header.stride;
+    }
+
+    int32_t hor_res = lv_display_get_horizontal_resolution(disp);
+    int32_t ver_res = lv_display_get_vertical_resolution(disp);
+    if(lines > (uint32_t)ver_res) lines = (uint32_t)ver_res;
+
+    /*A layer chunk is allocated from the LVGL heap while a simple layer is drawn*/
+    uint32_t layer_bytes = LV_DRAW_LAYER_SIMPLE_BUF_SIZE;
+
+    printf("RAM: %dx%d %s, %u draw buffer(s) %.1f KB (%u lines each), "
+           "simple layer chunk %.1f KB, total %.1f KB (LVGL heap %.0f KB)\n",
+           (int)hor_res, (int)ver_res, cf_name(lv_display_get_color_format(disp)),
+           (unsigned)buf_cnt, buf_bytes / 1024.0, (unsigned)lines,
+           layer_bytes / 1024.0, (buf_bytes + layer_bytes) / 1024.0, LV_MEM_SIZE / 1024.0);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static const char * cf_name(lv_color_format_t cf)
+{
+    switch(cf) {
+        case LV_COLOR_FORMAT_RGB565:
+            return "RGB565";
+        case LV_COLOR_FORMAT_RGB888:
+            return "RGB888";
+        case LV_COLOR_FORMAT_XRGB8888:
+            return "XRGB8888";
+        case LV_COLOR_FORMAT_ARGB8888:
+            return "ARGB8888";
+        default:
+            return "?";
+    }
+}
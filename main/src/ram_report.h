@@ -0,0 +1,31 @@
+/**
+ * @file ram_report.h
+ * Prints the RAM the renderer needs besides the LVGL heap: the display's draw
+ * buffers and the simple layer chunk (LV_DRAW_LAYER_SIMPLE_BUF_SIZE), so the
+ * buffer configuration can be checked against the device's internal RAM.
+ */
+
+#ifndef RAM_REPORT_H
+#define RAM_REPORT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lvgl/lvgl.h"
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/** Print the draw buffer and layer RAM of `disp`. Call it after the buffers are set. */
+void ram_report_print(lv_display_t * disp);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*RAM_REPORT_H*/
@@ -0,0 +1,139 @@
+
+/**
+ * @file render_bench
+ * Software render throughput on the headless backend.
+ *
+ * Opens every page and renders it full screen `--frames` times with lv_refr_now().
+ * Timers don't run between the frames, so every build renders exactly the same
+ * content. Build with -DLV_MT_RENDER=ON -DLV_MT_RENDER_UNITS=<n> to compare draw
+ * unit counts; render_scaling.py in the repository root does that for 1..N.
+ *
+ * Usage: render_bench [--frames n] [--width px] [--height px]
+ * Output: CSV, one line per page plus a total line
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "lvgl/lvgl.h"
+#include "headless_display.h"
+#include "../ui/my_ui.h"
+#include "page_manager.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DEFAULT_FRAMES          200
+#define WARMUP_FRAMES           5
+#define STARTUP_TIMEOUT_MS      10000
+#define ROOT_PAGE               "page_menu"
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern PageManager g_pageManager;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint64_t render_frames(lv_display_t * disp, uint32_t frames);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+int main(int argc, char ** argv)
+{
+    uint32_t frames = DEFAULT_FRAMES;
+    int32_t width = 240;
+    int32_t height = 320;
+
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--frames") == 0 && i + 1 < argc) frames = (uint32_t)atoi(argv[++i]);
+        else if(strcmp(argv[i], "--width") == 0 && i + 1 < argc) width = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--height") == 0 && i + 1 < argc) height = atoi(argv[++i]);
+        else {
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if(frames == 0) frames = 1;
+
+    lv_init();
+    lv_display_t * disp = headless_display_create(width, height);
+    if(disp == NULL) {
+        fprintf(stderr, "Failed to create the headless display\n");
+        return 1;
+    }
+    headless_tick_set_virtual(true);
+
+    my_ui_init();
+
+    lv_lock();
+    for(uint32_t t = 0; t < STARTUP_TIMEOUT_MS && g_pageManager.currentPage() != ROOT_PAGE; t += LV_DEF_REFR_PERIOD) {
+        headless_tick_advance(LV_DEF_REFR_PERIOD);
+        lv_unlock();
+        lv_timer_handler();
+        lv_lock();
+    }
+    if(g_pageManager.currentPage() != ROOT_PAGE) g_pageManager.gotoPageAndDestroy(ROOT_PAGE);
+    g_pageManager.setBuildBudget(0);
+    lv_unlock();
+
+    fprintf(stderr, "Draw units: %d, resolution: %dx%d, frames per page: %u\n",
+            (int)LV_DRAW_SW_DRAW_UNIT_CNT, (int)width, (int)height, (unsigned)frames);
+
+    printf("page,units,frames,total_us,frame_us,fps,mpx_per_s\n");
+    uint64_t all_us = 0;
+    uint32_t all_frames = 0;
+    uint64_t px = (uint64_t)width * height;
+
+    for(const std::string & name : g_pageManager.pageNames()) {
+        if(name == "pre_page") continue;
+
+        lv_lock();
+        bool is_root = name == ROOT_PAGE;
+        if(!is_root) g_pageManager.gotoPage(name);
+        render_frames(disp, WARMUP_FRAMES);
+        uint64_t us = render_frames(disp, frames);
+        if(!is_root) {
+            g_pageManager.back();
+            g_pageManager.flushTeardown();
+        }
+        lv_unlock();
+
+        all_us += us;
+        all_frames += frames;
+        printf("%s,%d,%u,%llu,%.1f,%.1f,%.2f\n", name.c_str(), (int)LV_DRAW_SW_DRAW_UNIT_CNT, (unsigned)frames,
+               (unsigned long long)us, (double)us / frames, frames * 1e6 / us, px * frames / (double)us);
+    }
+
+    if(all_us) {
+        printf("total,%d,%u,%llu,%.1f,%.1f,%.2f\n", (int)LV_DRAW_SW_DRAW_UNIT_CNT, (unsigned)all_frames,
+               (unsigned long long)all_us, (double)all_us / all_frames, all_frames * 1e6 / all_us,
+               px * all_frames / (double)all_us);
+    }
+    return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Invalidate and render the whole active screen; returns the time in microseconds*/
+static uint64_t render_frames(lv_display_t * disp, uint32_t frames)
+{
+    auto start = std::chrono::steady_clock::now();
+    for(uint32_t i = 0; i < frames; i++) {
+        lv_obj_invalidate(lv_screen_active());
+        lv_refr_now(disp);
+    }
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,312 @@
+/**
+ * @file render_cost.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifndef _DEFAULT_SOURCE
+  #define _DEFAULT_SOURCE
+#endif
+
+#include "render_cost.h"
+#include "lvgl/lvgl_private.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+  #include <Windows.h>
+#else
+  #include <time.h>
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Draw units that can be wrapped (software, and e.g. a GPU unit)*/
+#define MAX_UNITS               4
+/*Pending tasks of a layer checked per dispatch; normally only a few wait with LV_OS_NONE*/
+#define MAX_PENDING             256
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    lv_draw_unit_t * unit;
+    int32_t (*dispatch_cb)(lv_draw_unit_t * draw_unit, lv_layer_t * layer);
+} unit_slot_t;
+
+typedef struct {
+    render_cost_entry_t e;
+    const lv_obj_class_t * class_p;
+    char page[RENDER_COST_NAME_LEN];
+} class_slot_t;
+
+typedef struct {
+    render_cost_entry_t e;
+    /*Identity of the widget, so a hit needs no string building; the class slot gives the page*/
+    const lv_obj_t * obj;
+    const class_slot_t * cls;
+    lv_area_t coords;
+} widget_slot_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static int32_t dispatch_cb(lv_draw_unit_t * draw_unit, lv_layer_t * layer);
+static void display_event_cb(lv_event_t * e);
+static void account(const lv_draw_task_t * t, uint64_t ns);
+static widget_slot_t * widget_slot(const lv_obj_t * obj, const class_slot_t * cls);
+static class_slot_t * class_slot(const lv_obj_class_t * class_p);
+static const char * class_name(const lv_obj_class_t * class_p);
+static int entry_cmp(const void * a, const void * b);
+static uint64_t now_ns(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static unit_slot_t units[MAX_UNITS];
+static uint32_t unit_cnt;
+static render_cost_page_cb_t page_cb;
+static uint32_t report_top;
+
+/*Copy of the active page name, refreshed at the start of each frame*/
+static char page[RENDER_COST_NAME_LEN];
+
+/*The last entries collect what doesn't fit*/
+static widget_slot_t widgets[RENDER_COST_MAX_WIDGETS + 1];
+static uint32_t widget_cnt;
+static class_slot_t classes[RENDER_COST_MAX_CLASSES + 1];
+static uint32_t class_cnt;
+static render_cost_entry_t total;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+bool render_cost_init(lv_display_t * disp, render_cost_page_cb_t cb, uint32_t top)
+{
+#if LV_USE_OS != LV_OS_NONE
+    LV_UNUSED(disp);
+    LV_UNUSED(cb);
+    LV_UNUSED(top);
+    fprintf(stderr, "Render cost: draw tasks run on render threads and can't be timed, build with LV_OS_NONE\n");
+    return false;
+#else
+    page_cb = cb;
+    report_top = top ? top : 10;
+    render_cost_reset();
+
+    for(lv_draw_unit_t * u = LV_GLOBAL_DEFAULT()->draw_info.unit_head; u && unit_cnt < MAX_UNITS; u = u->next) {
+        if(u->dispatch_cb == NULL || u->dispatch_cb == dispatch_cb) continue;
+        units[unit_cnt].unit = u;
+        units[unit_cnt].dispatch_cb = u->dispatch_cb;
+        u->dispatch_cb = dispatch_cb;
+        unit_cnt++;
+    }
+    lv_display_add_event_cb(disp, display_event_cb, LV_EVENT_RENDER_START, NULL);
+    return unit_cnt > 0;
+#endif
+}
+
+uint32_t render_cost_get_top(render_cost_group_t group, render_cost_entry_t * out, uint32_t max)
+{
+    uint32_t cnt = 0;
+    if(group == RENDER_COST_BY_WIDGET) {
+        render_cost_entry_t * all = malloc(sizeof(render_cost_entry_t) * (RENDER_COST_MAX_WIDGETS + 1));
+        if(all == NULL) return 0;
+        for(uint32_t i = 0; i < widget_cnt; i++) all[cnt++] = widgets[i].e;
+        if(widgets[RENDER_COST_MAX_WIDGETS].e.tasks) all[cnt++] = widgets[RENDER_COST_MAX_WIDGETS].e;
+        qsort(all, cnt, sizeof(render_cost_entry_t), entry_cmp);
+        if(cnt > max) cnt = max;
+        memcpy(out, all, sizeof(render_cost_entry_t) * cnt);
+        free(all);
+    }
+    else {
+        render_cost_entry_t all[RENDER_COST_MAX_CLASSES + 1];
+        for(uint32_t i = 0; i < class_cnt; i++) all[cnt++] = classes[i].e;
+        if(classes[RENDER_COST_MAX_CLASSES].e.tasks) all[cnt++] = classes[RENDER_COST_MAX_CLASSES].e;
+        qsort(all, cnt, sizeof(render_cost_entry_t), entry_cmp);
+        if(cnt > max) cnt = max;
+        memcpy(out, all, sizeof(render_cost_entry_t) * cnt);
+    }
+    return cnt;
+}
+
+void render_cost_get_total(render_cost_entry_t * out)
+{
+    *out = total;
+}
+
+void render_cost_reset(void)
+{
+    memset(widgets, 0, sizeof(widgets));
+    lv_strlcpy(widgets[RENDER_COST_MAX_WIDGETS].e.name, "(other)", RENDER_COST_NAME_LEN);
+    widget_cnt = 0;
+    memset(classes, 0, sizeof(classes));
+    lv_strlcpy(classes[RENDER_COST_MAX_CLASSES].e.name, "(other)", RENDER_COST_NAME_LEN);
+    class_cnt = 0;
+    memset(&total, 0, sizeof(total));
+    lv_strlcpy(total.name, "total", RENDER_COST_NAME_LEN);
+}
+
+void render_cost_log_report(void)
+{
+    if(unit_cnt == 0) return;
+
+    if(total.tasks == 0) {
+        printf("Render cost: no draw tasks\n");
+        return;
+    }
+    printf("Render cost: %u draw tasks, %.2f ms\n", (unsigned)total.tasks, total.ns / 1000000.0);
+
+    render_cost_entry_t * list = malloc(sizeof(render_cost_entry_t) * report_top);
+    if(list == NULL) return;
+
+    printf("  %9s %7s %6s  %s\n", "ms", "tasks", "share", "class");
+    uint32_t cnt = render_cost_get_top(RENDER_COST_BY_CLASS, list, report_top);
+    for(uint32_t i = 0; i < cnt; i++) {
+        printf("  %9.3f %7u %5.1f%%  %s\n", list[i].ns / 1000000.0, (unsigned)list[i].tasks,
+               list[i].ns * 100.0 / total.ns, list[i].name);
+    }
+
+    printf("  %9s %7s %6s  %s\n", "ms", "tasks", "share", "widget");
+    cnt = render_cost_get_top(RENDER_COST_BY_WIDGET, list, report_top);
+    for(uint32_t i = 0; i < cnt; i++) {
+        printf("  %9.3f %7u %5.1f%%  %s\n", list[i].ns / 1000000.0, (unsigned)list[i].tasks,
+               list[i].ns * 100.0 / total.ns, list[i].name);
+    }
+    free(list);
+    render_cost_reset();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*Time the task the draw unit executes. With LV_OS_NONE it's the one that turns ready during the call.*/
+static int32_t dispatch_cb(lv_draw_unit_t * draw_unit, lv_layer_t * layer)
+{
+    unit_slot_t * slot = NULL;
+    for(uint32_t i = 0; i < unit_cnt; i++) {
+        if(units[i].unit == draw_unit) slot = &units[i];
+    }
+    if(slot == NULL) return 0;
+
+    lv_draw_task_t * pending[MAX_PENDING];
+    uint32_t pending_cnt = 0;
+    for(lv_draw_task_t * t = layer->draw_task_head; t && pending_cnt < MAX_PENDING; t = t->next) {
+        if(t->state != LV_DRAW_TASK_STATE_READY && t->state != LV_DRAW_TASK_STATE_IN_PROGRESS) {
+            pending[pending_cnt++] = t;
+        }
+    }
+
+    uint64_t start = now_ns();
+    int32_t taken = slot->dispatch_cb(draw_unit, layer);
+    uint64_t ns = now_ns() - start;
+    if(taken <= 0) return taken;
+
+    const lv_draw_task_t * done = NULL;
+    for(uint32_t i = 0; i < pending_cnt; i++) {
+        if(pending[i]->state == LV_DRAW_TASK_STATE_READY) {
+            done = pending[i];
+            break;
+        }
+    }
+    account(done, ns);
+    return taken;
+}
+
+static void display_event_cb(lv_event_t * e)
+{
+    LV_UNUSED(e);
+    /*Once per frame: the callback may be slow*/
+    const char * p = page_cb ? page_cb() : NULL;
+    lv_strlcpy(page, p ? p : "", sizeof(page));
+}
+
+static void account(const lv_draw_task_t * t, uint64_t ns)
+{
+    total.tasks++;
+    total.ns += ns;
+
+    const lv_obj_t * obj = t ? ((const lv_draw_dsc_base_t *)t->draw_dsc)->obj : NULL;
+    const lv_obj_class_t * class_p = obj ? lv_obj_get_class(obj) : NULL;
+
+    class_slot_t * c = class_slot(class_p);
+    c->e.tasks++;
+    c->e.ns += ns;
+    widget_slot_t * w = widget_slot(obj, c);
+    w->e.tasks++;
+    w->e.ns += ns;
+}
+
+static widget_slot_t * widget_slot(const lv_obj_t * obj, const class_slot_t * cls)
+{
+    lv_area_t coords = {0};
+    if(obj) lv_obj_get_coords(obj, &coords);
+
+    for(uint32_t i = 0; i < widget_cnt; i++) {
+        widget_slot_t * w = &widgets[i];
+        if(w->obj == obj && w->cls == cls && lv_area_is_equal(&w->coords, &coords)) return w;
+    }
+    if(widget_cnt == RENDER_COST_MAX_WIDGETS) return &widgets[RENDER_COST_MAX_WIDGETS];
+
+    widget_slot_t * w = &widgets[widget_cnt++];
+    w->obj = obj;
+    w->cls = cls;
+    w->coords = coords;
+    if(obj) {
+        lv_snprintf(w->e.name, RENDER_COST_NAME_LEN, "%s%s%s (%d,%d %dx%d)", cls->page, cls->page[0] ? ": " : "",
+                    class_name(cls->class_p), (int)coords.x1, (int)coords.y1,
+                    (int)lv_area_get_width(&coords), (int)lv_area_get_height(&coords));
+    }
+    else {
+        lv_strlcpy(w->e.name, cls->e.name, RENDER_COST_NAME_LEN);
+    }
+    return w;
+}
+
+static class_slot_t * class_slot(const lv_obj_class_t * class_p)
+{
+    for(uint32_t i = 0; i < class_cnt; i++) {
+        if(classes[i].class_p == class_p && strcmp(classes[i].page, page) == 0) return &classes[i];
+    }
+    if(class_cnt == RENDER_COST_MAX_CLASSES) return &classes[RENDER_COST_MAX_CLASSES];
+
+    class_slot_t * c = &classes[class_cnt++];
+    c->class_p = class_p;
+    lv_strlcpy(c->page, page, RENDER_COST_NAME_LEN);
+    lv_snprintf(c->e.name, RENDER_COST_NAME_LEN, "%s%s%s", page, page[0] ? ": " : "",
+                class_p ? class_name(class_p) : "(no widget)");
+    return c;
+}
+
+static const char * class_name(const lv_obj_class_t * class_p)
+{
+    return class_p && class_p->name ? class_p->name : "?";
+}
+
+static int entry_cmp(const void * a, const void * b)
+{
+    const render_cost_entry_t * ea = a;
+    const render_cost_entry_t * eb = b;
+    if(ea->ns != eb->ns) return ea->ns < eb->ns ? 1 : -1;
+    return 0;
+}
+
+static uint64_t now_ns(void)
+{
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER cnt;
+    if(freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&cnt);
+    return (uint64_t)(cnt.QuadPart / freq.QuadPart * 1000000000 + cnt.QuadPart % freq.QuadPart * 1000000000 / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
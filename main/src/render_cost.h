@@ -0,0 +1,94 @@
+/**
+ * @file render_cost.h
+ * Render time per widget: every draw task the software renderer executes is
+ * timed and attributed to the object that created it (`base.obj` of its draw
+ * descriptor), then accumulated per widget and per widget class on each page.
+ *
+ * The draw units' dispatch callbacks are wrapped. With LV_OS_NONE a draw
+ * task is executed inside the dispatch call, so its time is measured
+ * exactly; with render threads (the LV_MT_RENDER build) the execution
+ * happens on other threads and can't be timed, so it is not supported.
+ */
+
+#ifndef RENDER_COST_H
+#define RENDER_COST_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Widgets and classes tracked between two resets; the rest is counted as "(other)"*/
+#ifndef RENDER_COST_MAX_WIDGETS
+  #define RENDER_COST_MAX_WIDGETS   256
+#endif
+
+#ifndef RENDER_COST_MAX_CLASSES
+  #define RENDER_COST_MAX_CLASSES   64
+#endif
+
+#define RENDER_COST_NAME_LEN        64
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+typedef enum {
+    RENDER_COST_BY_WIDGET,          /*"page: class (x,y wxh)"*/
+    RENDER_COST_BY_CLASS,           /*"page: class"*/
+} render_cost_group_t;
+
+typedef struct {
+    char name[RENDER_COST_NAME_LEN];
+    uint32_t tasks;                 /*Draw tasks executed*/
+    uint64_t ns;                    /*Time spent executing them*/
+} render_cost_entry_t;
+
+/** Returns the name of the active page, or NULL */
+typedef const char * (*render_cost_page_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Wrap the draw units and start attributing the draw tasks.
+ * Call it after `lv_init`.
+ * @param disp      the page name is read at the start of each of its frames
+ * @param page_cb   returns the active page name, can be NULL
+ * @param report_top number of widgets `render_cost_log_report` prints
+ * @return          false with render threads (LV_USE_OS != LV_OS_NONE)
+ */
+bool render_cost_init(lv_display_t * disp, render_cost_page_cb_t page_cb, uint32_t report_top);
+
+/**
+ * Copy the most expensive entries since the last reset, most time first.
+ * @param group     per widget or per class
+ * @param out       destination
+ * @param max       size of `out`
+ * @return          number of entries copied
+ */
+uint32_t render_cost_get_top(render_cost_group_t group, render_cost_entry_t * out, uint32_t max);
+
+/** Total draw task time and count since the last reset, including tasks without an object */
+void render_cost_get_total(render_cost_entry_t * total);
+
+void render_cost_reset(void);
+
+/** Print the classes and the most expensive widgets since the last call, then reset */
+void render_cost_log_report(void);
+
+#ifdef __cplusplus
+} /*extern "C"*/
+#endif
+
+#endif /*RENDER_COST_H*/
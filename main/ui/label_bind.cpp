@@ -0,0 +1,115 @@
+// label_bind.cpp
+// 标签绑定实现
+#include "label_bind.h"
+#include <cstdarg>
+#include <unordered_map>
+
+namespace {
+
+struct BindState {
+    const char* fmt = nullptr;          // 格式串只比较指针，调用方传入字面量
+    float precision = 0;
+    size_t count = 0;
+    int64_t keys[label_bind_detail::MAX_ARGS] = {};
+};
+
+std::unordered_map<lv_obj_t*, BindState> g_states;
+LabelBindStats g_stats = {};
+
+
+// 标签删除时移除缓存，避免地址被新对象复用后误判为未变化
+void label_delete_cb(lv_event_t* e) {
+    g_states.erase(static_cast<lv_obj_t*>(lv_event_get_target(e)));
+}
+
+
+// 设置文本后标签内容不再对应缓存的参数
+void forget_values(lv_obj_t* label) {
+    auto it = g_states.find(label);
+    if(it != g_states.end()) it->second.fmt = nullptr;
+}
+
+
+bool set_if_changed(lv_obj_t* label, const char* text) {
+    const char* cur = lv_label_get_text(label);
+    if(cur && std::strcmp(cur, text) == 0) {
+        g_stats.skipped_text++;
+        return false;
+    }
+    lv_label_set_text(label, text);
+    g_stats.updated++;
+    return true;
+}
+
+} // namespace
+
+
+bool label_bind_detail::values_unchanged(lv_obj_t* label, const char* fmt, float precision,
+                                         const int64_t* keys, size_t count) {
+    g_stats.calls++;
+
+    auto it = g_states.find(label);
+    if(it == g_states.end()) {
+        it = g_states.emplace(label, BindState()).first;
+        lv_obj_add_event_cb(label, label_delete_cb, LV_EVENT_DELETE, nullptr);
+    }
+
+    BindState& st = it->second;
+    if(st.fmt == fmt && st.precision == precision && st.count == count &&
+       std::memcmp(st.keys, keys, count * sizeof(int64_t)) == 0) {
+        g_stats.skipped_values++;
+        return true;
+    }
+    st.fmt = fmt;
+    st.precision = precision;
+    st.count = count;
+    std::memcpy(st.keys, keys, count * sizeof(int64_t));
+    return false;
+}
+
+
+bool label_bind_detail::apply_text(lv_obj_t* label, const char* text) {
+    return set_if_changed(label, text);
+}
+
+
+bool label_bind_set_text(lv_obj_t* label, const char* text) {
+    if(!label || !text) return false;
+    g_stats.calls++;
+    forget_values(label);
+    return set_if_changed(label, text);
+}
+
+
+bool label_bind_set_text_fmt(lv_obj_t* label, const char* fmt, ...) {
+    if(!label || !fmt) return false;
+
+    char text[label_bind_detail::TEXT_LEN];
+    va_list args;
+    va_start(args, fmt);
+    lv_vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    return label_bind_set_text(label, text);
+}
+
+
+LabelBindStats label_bind_get_stats() {
+    return g_stats;
+}
+
+
+void label_bind_reset_stats() {
+    g_stats = {};
+}
+
+
+void label_bind_log_stats() {
+    LabelBindStats s = label_bind_get_stats();
+    if(s.calls == 0) return;
+
+    uint32_t skipped = s.skipped_values + s.skipped_text;
+    printf("Label bind: %u updates, %u redraws saved (%.1f%%): %u unchanged values, %u unchanged text\n",
+           (unsigned)s.calls, (unsigned)skipped, skipped * 100.0 / s.calls,
+           (unsigned)s.skipped_values, (unsigned)s.skipped_text);
+    label_bind_reset_stats();
+}
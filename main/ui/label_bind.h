@@ -0,0 +1,80 @@
+// label_bind.h
+// 标签绑定：缓存每个标签上次显示的数值和文本，未变化时跳过格式化、文本重新分配和重绘
+//
+// 定时刷新的页面每次都调用lv_label_set_text_fmt，即使显示内容完全相同，LVGL也会重新分配文本并使标签失效重绘。
+// - label_bind_values：浮点参数按精度量化后与上次比较，全部相同时连格式化也跳过
+// - label_bind_set_text / label_bind_set_text_fmt：与标签当前文本比较，相同时不设置
+// 同一个标签的所有更新都应通过这些函数，直接调用lv_label_set_text会使数值缓存失效而不自知。
+#pragma once
+#include "lvgl/lvgl.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+
+struct LabelBindStats {
+    uint32_t calls;             // 调用次数
+    uint32_t skipped_values;    // 数值在精度内未变化，未格式化
+    uint32_t skipped_text;      // 格式化后文本与当前相同
+    uint32_t updated;           // 实际设置了文本（标签重绘）
+};
+
+// 文本与标签当前内容相同时跳过；返回true表示文本已更新
+bool label_bind_set_text(lv_obj_t* label, const char* text);
+bool label_bind_set_text_fmt(lv_obj_t* label, const char* fmt, ...) LV_FORMAT_ATTRIBUTE(2, 3);
+
+// 数值绑定：浮点参数按precision量化（%.1f对应0.1），整数和字符串按值比较；
+// 格式和所有参数都与上次相同时直接返回false。最多8个参数，格式化结果最长127字节。
+template<typename... Args>
+bool label_bind_values(lv_obj_t* label, float precision, const char* fmt, Args... args);
+
+LabelBindStats label_bind_get_stats();
+void label_bind_reset_stats();
+// 打印更新次数和节省的重绘次数，然后清零
+void label_bind_log_stats();
+
+
+// ---- 实现细节 ----
+namespace label_bind_detail {
+
+constexpr size_t MAX_ARGS = 8;
+constexpr size_t TEXT_LEN = 128;
+
+// 参数与上次相同时返回true（并计数），否则记录新参数
+bool values_unchanged(lv_obj_t* label, const char* fmt, float precision, const int64_t* keys, size_t count);
+// 设置格式化好的文本，不重复计数调用次数
+bool apply_text(lv_obj_t* label, const char* text);
+
+template<typename T>
+int64_t key(T v, float precision) {
+    if constexpr(std::is_floating_point_v<T>) {
+        // precision<=0：按1e-6比较
+        return std::llround(static_cast<double>(v) / (precision > 0 ? precision : 1e-6f));
+    } else if constexpr(std::is_integral_v<T> || std::is_enum_v<T>) {
+        return static_cast<int64_t>(v);
+    } else {
+        static_assert(std::is_convertible_v<T, const char*>, "label_bind_values: numbers and strings only");
+        // 字符串按内容比较（FNV-1a）
+        uint64_t h = 1469598103934665603ull;
+        for(const char* p = v ? v : ""; *p; p++) h = (h ^ static_cast<uint8_t>(*p)) * 1099511628211ull;
+        return static_cast<int64_t>(h);
+    }
+}
+
+} // namespace label_bind_detail
+
+
+template<typename... Args>
+bool label_bind_values(lv_obj_t* label, float precision, const char* fmt, Args... args) {
+    static_assert(sizeof...(Args) <= label_bind_detail::MAX_ARGS, "label_bind_values: too many arguments");
+    if(!label) return false;
+
+    int64_t keys[sizeof...(Args) + 1] = {label_bind_detail::key(args, precision)...};
+    if(label_bind_detail::values_unchanged(label, fmt, precision, keys, sizeof...(Args))) return false;
+
+    char text[label_bind_detail::TEXT_LEN];
+    std::snprintf(text, sizeof(text), fmt, args...);
+    return label_bind_detail::apply_text(label, text);
+}
@@ -4,14 +4,19 @@
 
 #include "page_manager.h"
 #include "pages_common.h"
+#include "label_bind.h"
 #include "system/system.h"
+#include "system/dir_loader.hpp"
 
 // 全局页面管理器
 PageManager g_pageManager;
 
 
+// 多线程渲染配置（LV_OS_PTHREAD）下，以下入口函数在主循环中、lv_timer_handler之外调用，需要持有lv_lock
 extern "C" void my_ui_init(void)
 {
+    lv_lock();
+
     // 初始化硬件资源
     time_service::init();
     battery_service::init();
@@ -22,17 +27,65 @@ extern "C" void my_ui_init(void)
 
 
     // 注册页面（直接绑定事件）
-    g_pageManager.registerPage("pre_page", createPage_prepage); // 暂时禁用，缺少Lottie数据
+    // 启动页只显示一次，不进入页面缓存
+    g_pageManager.registerPage("pre_page", createPage_prepage, false); // 暂时禁用，缺少Lottie数据
     g_pageManager.registerPage("page_menu", createPage_menu);
     g_pageManager.registerPage("page_settings", createPage_settings);
-    g_pageManager.registerPage("page_mpu6050", createPage_mpu6050);
-    g_pageManager.registerPage("page_qmc5883l", createPage_qmc5883l);
+    // 传感器页面不可见时停止数据采集，页面定时器由页面管理器自动暂停
+    g_pageManager.registerPage("page_mpu6050", createPage_mpu6050,
+                               {.onPause = pausePage_mpu6050, .onResume = resumePage_mpu6050,
+                                .onSave = savePage_mpu6050, .onRestore = restorePage_mpu6050});
+    g_pageManager.registerPage("page_qmc5883l", createPage_qmc5883l,
+                               {.onPause = pausePage_qmc5883l, .onResume = resumePage_qmc5883l});
     g_pageManager.registerPage("page_time", createPage_time);
     g_pageManager.registerPage("page_wifi", createPage_wifi);
     g_pageManager.registerPage("page_pmu", createPage_pmu);
-    g_pageManager.registerPage("page_sd_files", createPage_sd_files);
+    // 内存紧张时文件浏览页可被销毁，返回时恢复目录和滚动位置
+    g_pageManager.registerPage("page_sd_files", createPage_sd_files,
+                               {.onSave = savePage_sd_files, .onRestore = restorePage_sd_files});
     g_pageManager.registerPage("page1", createPage1);
     g_pageManager.registerPage("page2", createPage2);
     // 启动时加载主菜单页面
     g_pageManager.gotoPage("pre_page");
+
+    lv_unlock();
+}
+
+
+extern "C" const char * my_ui_current_page(void)
+{
+    // 页面名称只在跳转时变化，缓存字符串避免每帧分配
+    static std::string name;
+    lv_lock();
+    std::string cur = g_pageManager.currentPage();
+    lv_unlock();
+    if(cur != name) name = cur;
+    return name.c_str();
+}
+
+
+extern "C" void my_ui_log_stats(void)
+{
+    lv_lock();
+    label_bind_log_stats();
+    lv_unlock();
+    fs_dir_cache_log_stats();
+}
+
+
+extern "C" void my_ui_set_wake_cb(void (*cb)(void))
+{
+    DirLoader::instance().setNotify(cb);
+}
+
+
+extern "C" int my_ui_idle(uint32_t idle_ms)
+{
+    lv_lock();
+    // 先交付后台目录加载的结果，有结果时立即回到lv_timer_handler刷新
+    bool worked = DirLoader::instance().dispatch();
+    // 利用空闲间隙预取下一个可能访问的页面
+    if (!worked) worked = g_pageManager.runIdleTask(idle_ms);
+    lv_unlock();
+    return worked ? 1 : 0;
 }
@@ -2,6 +2,7 @@
 #ifndef MY_UI_H
 #define MY_UI_H
 
+#include <stdint.h>
 
 
 #ifdef __cplusplus
@@ -11,6 +12,19 @@ extern "C" {
 //UI应用入口
 void my_ui_init(void);
 
+//主循环空闲回调，idle_ms为距离下一个LVGL定时器的时间；做了工作返回1
+//后台线程的结果（如目录加载的批次）也在这里交给UI
+int my_ui_idle(uint32_t idle_ms);
+
+//后台线程有结果要交给my_ui_idle时调用的唤醒函数，可以在任意线程调用
+void my_ui_set_wake_cb(void (*cb)(void));
+
+//当前页面名称，用于帧统计等调试输出
+const char * my_ui_current_page(void);
+
+//打印UI层统计（标签绑定节省的重绘次数、目录缓存命中率），然后清零
+void my_ui_log_stats(void);
+
 
 #ifdef __cplusplus
 }
@@ -1,6 +1,7 @@
 // page1.cpp
 #include "lvgl/lvgl.h"
 #include "page_manager.h"
+#include "page_scope.h"
 #include "pages_common.h"
 #include <iostream>
 extern PageManager g_pageManager;
@@ -67,6 +68,7 @@ static void screen_backbtn_cb(lv_event_t *e) {
 }
 
 lv_obj_t* createPage1() {
+    TRACE_FUNC();
     LV_DRAW_BUF_DEFINE_STATIC(draw_buf, CANVAS_WIDTH, CANVAS_HEIGHT, LV_COLOR_FORMAT_ARGB8888);
     LV_DRAW_BUF_INIT_STATIC(draw_buf);
 
@@ -112,8 +114,8 @@ lv_obj_t* createPage1() {
 
 
 
-    lv_timer_t * timer = lv_timer_create(timer_cb, 10, NULL);
-    lv_obj_set_user_data(page1, timer);
+    // 定时器记录在页面资源作用域中，页面删除时统一释放
+    PageScope::of(page1).createTimer(timer_cb, 10, NULL);
 
     return page1;
 }
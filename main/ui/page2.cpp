@@ -4,6 +4,7 @@
 #include "pages_common.h"
 extern PageManager g_pageManager;
 lv_obj_t* createPage2() {
+    TRACE_FUNC();
     lv_obj_t *page = lv_obj_create(NULL);
     lv_obj_t *label = lv_label_create(page);
     lv_label_set_text(label, "this is Page 2");
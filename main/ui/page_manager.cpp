@@ -1,109 +1,448 @@
 // page_manager.cpp
 // 页面管理器实现，负责页面注册、跳转、返回、销毁等功能
 #include "page_manager.h"
+#include "page_scope.h"
+#include "system/esp_log.h"
+#include "system/trace.h"
+#include <chrono>
+#include <algorithm>
+
+static const char *TAG = "PageManager";
+
+// 空闲间隙小于该值时不做预取（毫秒）
+#define PREFETCH_MIN_IDLE_MS    5
+// 跳转后等待切换动画结束再开始预取（毫秒）
+#define PREFETCH_SETTLE_MS      500
+// 空闲时检查内存压力的间隔（毫秒），检查需要遍历LVGL堆
+#define PRESSURE_CHECK_MS       500
+
+// 保留的页面销毁记录条数
+#define TEARDOWN_HISTORY_SIZE   16
+
+// 从start到现在经过的微秒数
+static uint32_t elapsed_us(std::chrono::steady_clock::time_point start) {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// 当前LVGL堆使用率（百分比）
+static uint8_t heap_used_pct() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.used_pct;
+}
+
+// 当前LVGL堆已用字节数
+static size_t heap_used_bytes() {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+// 追加构建步骤
+void PageBuilder::defer(Step step) {
+    steps.push_back(std::move(step));
+}
+
+
+// 在时间预算内依次执行构建步骤，单个步骤不可拆分，因此至少执行一步
+bool PageBuilder::run(uint32_t budget_us) {
+    auto start = std::chrono::steady_clock::now();
+    while(!steps.empty()) {
+        Step step = std::move(steps.front());
+        steps.pop_front();
+        step();
+        if(elapsed_us(start) >= budget_us) break;
+    }
+    return steps.empty();
+}
+
+
+// 执行剩余全部构建步骤
+void PageBuilder::runAll() {
+    while(!steps.empty()) {
+        Step step = std::move(steps.front());
+        steps.pop_front();
+        step();
+    }
+}
 
 
 // 注册页面创建函数，name为页面标识，func为页面创建回调
-void PageManager::registerPage(const std::string& name, PageCreateFunc func) {
-    pageFactories[name] = func;
+void PageManager::registerPage(const std::string& name, PageCreateFunc func, bool cacheable) {
+    pageFactories[name] = {[func](PageBuilder&) { return func(); }, cacheable, {}};
+}
+
+
+// 注册分步构建的页面创建函数
+void PageManager::registerPage(const std::string& name, PageBuildFunc func, bool cacheable) {
+    pageFactories[name] = {func, cacheable, {}};
+}
+
+
+// 注册页面创建函数及生命周期回调
+void PageManager::registerPage(const std::string& name, PageCreateFunc func, PageHooks hooks, bool cacheable) {
+    pageFactories[name] = {[func](PageBuilder&) { return func(); }, cacheable, std::move(hooks)};
+}
+
+
+void PageManager::registerPage(const std::string& name, PageBuildFunc func, PageHooks hooks, bool cacheable) {
+    pageFactories[name] = {func, cacheable, std::move(hooks)};
+}
+
+
+// 获取页面：优先复用缓存，未命中时调用工厂函数创建
+lv_obj_t* PageManager::acquirePage(const std::string& name) {
+    auto it = pageCache.find(name);
+    if(it != pageCache.end()) {
+        lv_obj_t* page = it->second.page;
+        cacheUsed -= it->second.bytes;
+        cacheLru.erase(it->second.lru_pos);
+        pageCache.erase(it);
+        cacheHits++;
+        ESP_LOGD(TAG, "Cache hit: %s", name.c_str());
+        return page;
+    }
+
+    // 正在空闲预取的页面：剩余步骤改由构建定时器推进
+    if(prefetchBuild && prefetchBuild->name == name) {
+        lv_obj_t* page = prefetchBuild->page;
+        PendingBuild pb = std::move(*prefetchBuild);
+        prefetchBuild.reset();
+        cacheHits++;
+        ESP_LOGD(TAG, "Prefetch taken over: %s", name.c_str());
+        if(buildBudgetUs > 0) {
+            queueBuild(std::move(pb));
+        } else {
+            pb.builder.runAll();
+            size_t after = heap_used_bytes();
+            pageSizes[name] = after > pb.heap_before ? after - pb.heap_before : 0;
+        }
+        return page;
+    }
+
+    cacheMisses++;
+    lv_obj_t* page = buildPage(name, true);
+    ESP_LOGD(TAG, "Cache miss: %s (%u bytes)", name.c_str(), (unsigned)pageSizes[name]);
+    return page;
+}
+
+
+// 调用工厂函数创建页面骨架，延后的步骤留在builder中；restore不为空时在最后追加onRestore
+lv_obj_t* PageManager::startBuild(const std::string& name, PageBuilder& builder, const PageState* restore) {
+    // 同名旧页面尽量先删除完；仍在屏幕上的旧页面已释放资源，由页面的删除回调判断实例，不会重置新页面共用的静态变量
+    finishTeardown(name);
+
+    const PageEntry& entry = pageFactories[name];
+    lv_obj_t* page = entry.build(builder);
+    if(page) {
+        pageRuntime[page] = {name, false};
+        if(restore && entry.hooks.onRestore) {
+            builder.defer([page, state = *restore, cb = entry.hooks.onRestore]() { cb(page, state); });
+        }
+    }
+    return page;
+}
+
+
+// 调用工厂函数构建页面，并通过lv_mem_monitor记录页面占用的堆内存
+// incremental为true时工厂函数延后的步骤交给构建定时器，页面先以骨架显示
+lv_obj_t* PageManager::buildPage(const std::string& name, bool incremental, const PageState* restore) {
+    TRACE_SCOPE("PageManager::buildPage");
+    size_t before = heap_used_bytes();
+    PageBuilder builder;
+    lv_obj_t* page = startBuild(name, builder, restore);
+
+    if(!builder.done()) {
+        if(incremental && page && buildBudgetUs > 0) {
+            queueBuild({name, page, std::move(builder), before});
+            return page;
+        }
+        builder.runAll();
+    }
+
+    size_t after = heap_used_bytes();
+    pageSizes[name] = after > before ? after - before : 0;
+    return page;
+}
+
+
+// 剩余构建步骤交给构建定时器
+void PageManager::queueBuild(PendingBuild pb) {
+    pendingBuilds.push_back(std::move(pb));
+    if(!buildTimer) {
+        buildTimer = lv_timer_create([](lv_timer_t* t) {
+            static_cast<PageManager*>(lv_timer_get_user_data(t))->runPendingBuilds();
+        }, LV_DEF_REFR_PERIOD, this);
+    } else {
+        lv_timer_resume(buildTimer);
+    }
+    // 推迟到下一帧执行，保证骨架先被渲染出来
+    lv_timer_reset(buildTimer);
+}
+
+
+// 推进待构建页面，所有页面共享一帧的构建预算；最近跳转的页面（当前显示）优先
+void PageManager::runPendingBuilds() {
+    TRACE_SCOPE("PageManager::runPendingBuilds");
+    auto start = std::chrono::steady_clock::now();
+    while(!pendingBuilds.empty()) {
+        uint32_t used = elapsed_us(start);
+        if(used >= buildBudgetUs) break;
+
+        PendingBuild& pb = pendingBuilds.back();
+        if(!pb.builder.run(buildBudgetUs - used)) break;
+
+        // 构建完成前页面已被覆盖：最后一步可能重新启动了服务，再通知一次暂停
+        auto rt = pageRuntime.find(pb.page);
+        const PageHooks* hooks = hooksOf(pb.page);
+        if(rt != pageRuntime.end() && rt->second.paused && hooks && hooks->onPause) {
+            hooks->onPause(pb.page);
+        }
+
+        // 跨帧构建期间的其他分配也会计入，结果为近似值
+        size_t after = heap_used_bytes();
+        pageSizes[pb.name] = after > pb.heap_before ? after - pb.heap_before : 0;
+        ESP_LOGD(TAG, "Build finished: %s (%u bytes)", pb.name.c_str(), (unsigned)pageSizes[pb.name]);
+        pendingBuilds.pop_back();
+    }
+    if(pendingBuilds.empty()) lv_timer_pause(buildTimer);
+}
+
+
+// 丢弃页面未执行的构建步骤（步骤引用的控件即将随页面删除）
+bool PageManager::cancelBuild(lv_obj_t* page) {
+    for(auto it = pendingBuilds.begin(); it != pendingBuilds.end(); ++it) {
+        if(it->page == page) {
+            ESP_LOGD(TAG, "Build cancelled: %s", it->name.c_str());
+            pendingBuilds.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// 页面注册的生命周期回调
+const PageHooks* PageManager::hooksOf(lv_obj_t* page) const {
+    auto rt = pageRuntime.find(page);
+    if(rt == pageRuntime.end()) return nullptr;
+    auto fit = pageFactories.find(rt->second.name);
+    return fit == pageFactories.end() ? nullptr : &fit->second.hooks;
+}
+
+
+// 暂停页面：暂停页面通过资源作用域创建的定时器和可暂停订阅并调用onPause
+// 作用域在暂停期间创建的定时器和订阅同样处于暂停状态，直到页面恢复
+void PageManager::pausePage(lv_obj_t* page) {
+    auto rt = pageRuntime.find(page);
+    if(rt == pageRuntime.end() || rt->second.paused) return;
+    rt->second.paused = true;
+
+    PageScope& scope = PageScope::of(page);
+    scope.pause();
+
+    const PageHooks* hooks = hooksOf(page);
+    if(hooks && hooks->onPause) hooks->onPause(page);
+    ESP_LOGD(TAG, "Paused: %s (%u timers)", rt->second.name.c_str(), (unsigned)scope.timerCount());
+}
+
+
+// 恢复页面：恢复页面定时器和订阅并调用onResume
+void PageManager::resumePage(lv_obj_t* page) {
+    auto rt = pageRuntime.find(page);
+    if(rt == pageRuntime.end() || !rt->second.paused) return;
+    rt->second.paused = false;
+
+    if(PageScope* scope = PageScope::find(page)) scope->resume();
+
+    const PageHooks* hooks = hooksOf(page);
+    if(hooks && hooks->onResume) hooks->onResume(page);
+    ESP_LOGD(TAG, "Resumed: %s", rt->second.name.c_str());
+}
+
+
+// 页面被跳转进入：从缓存取出的页面先恢复，再调用onEnter
+void PageManager::enterPage(lv_obj_t* page) {
+    resumePage(page);
+    const PageHooks* hooks = hooksOf(page);
+    if(hooks && hooks->onEnter) hooks->onEnter(page);
+}
+
+
+// 页面离开页面栈：先暂停，再调用onLeave
+void PageManager::leavePage(lv_obj_t* page) {
+    pausePage(page);
+    const PageHooks* hooks = hooksOf(page);
+    if(hooks && hooks->onLeave) hooks->onLeave(page);
+}
+
+
+void PageManager::forgetPage(lv_obj_t* page) {
+    pageRuntime.erase(page);
+}
+
+
+// 设置分步构建每帧的时间预算（微秒）
+void PageManager::setBuildBudget(uint32_t budget_us) {
+    buildBudgetUs = budget_us;
+}
+
+
+// 页面离开页面栈时放入缓存，成功返回true；不可缓存时返回false，由调用方销毁
+bool PageManager::cachePage(const std::string& name, lv_obj_t* page) {
+    auto fit = pageFactories.find(name);
+    if(!page || fit == pageFactories.end() || !fit->second.cacheable || cacheBudget == 0) return false;
+    // 同名页面已在缓存中（页面栈中存在多个实例），只保留已缓存的那个
+    if(pageCache.count(name)) return false;
+
+    size_t bytes = pageSizes.count(name) ? pageSizes[name] : 0;
+    if(bytes > cacheBudget) return false;
+
+    // 为新页面腾出空间（页面已在离开页面栈时暂停）
+    evictCache(cacheBudget - bytes);
+
+    cacheLru.push_front(name);
+    pageCache[name] = {page, bytes, cacheLru.begin()};
+    cacheUsed += bytes;
+    return true;
+}
+
+
+// 按LRU顺序淘汰页面，直到缓存占用不超过limit；limit为0时清空缓存（包括测得大小为0的页面）
+void PageManager::evictCache(size_t limit) {
+    while(!cacheLru.empty() && (cacheUsed > limit || limit == 0)) {
+        auto it = pageCache.find(cacheLru.back());
+        cacheLru.pop_back();
+        if(it == pageCache.end()) continue;
+
+        ESP_LOGD(TAG, "Cache evict: %s (%u bytes)", it->first.c_str(), (unsigned)it->second.bytes);
+        cacheUsed -= it->second.bytes;
+        destroyPage(it->first, it->second.page);
+        pageCache.erase(it);
+        cacheEvictions++;
+    }
 }
 
 
 
 // 跳转到指定页面，自动保留当前页面（无动画）
 void PageManager::gotoPage(const std::string& name) {
+    TRACE_SCOPE("PageManager::gotoPage");
     if(pageFactories.count(name)) {
-        lv_obj_t* page = pageFactories[name]();
+        recordTransition(name);
+        relieveMemoryPressure();
+        lv_obj_t* page = acquirePage(name);
         if(!pageStack.empty()) {
-            pageStack.top().keep = true;
+            pageStack.back().keep = true;
+            pausePage(pageStack.back().page);
         }
-        pageStack.push({name, page, false});
+        pageStack.push_back({name, page, false});
         lv_screen_load(page);
+        enterPage(page);
     }
 }
 
 // 跳转到指定页面，带动画
 void PageManager::gotoPage(const std::string& name, lv_screen_load_anim_t anim_type, uint32_t time) {
+    TRACE_SCOPE("PageManager::gotoPage");
     if(pageFactories.count(name)) {
-        lv_obj_t* page = pageFactories[name]();
+        recordTransition(name);
+        relieveMemoryPressure();
+        lv_obj_t* page = acquirePage(name);
         if(!pageStack.empty()) {
-            pageStack.top().keep = true;
+            pageStack.back().keep = true;
+            pausePage(pageStack.back().page);
         }
-        pageStack.push({name, page, false});
+        pageStack.push_back({name, page, false});
         lv_screen_load_anim(page, anim_type, time, 0, false);
+        enterPage(page);
     }
 }
 
 // 跳转到指定页面，销毁当前页面（无动画）
 void PageManager::gotoPageAndDestroy(const std::string& name) {
+    TRACE_SCOPE("PageManager::gotoPageAndDestroy");
     if(pageFactories.count(name)) {
-        lv_obj_t* page = pageFactories[name]();
+        recordTransition(name);
+        relieveMemoryPressure();
+        // 先释放当前页面再创建新页面：跳转到同名页面时，旧页面的暂停回调和订阅注销不能作用于新页面
         if(!pageStack.empty()) {
-            auto cur = pageStack.top();
-            pageStack.pop();
-            // 异步安全销毁页面
-            lv_async_call([](void* obj){
-                lv_obj_t* page = static_cast<lv_obj_t*>(obj);
-                lv_timer_t* timer = (lv_timer_t*)lv_obj_get_user_data(page);
-                if (timer) lv_timer_del(timer);
-                lv_obj_clean(page);
-                lv_obj_del(page);
-            }, cur.page);
-        }
-        pageStack.push({name, page, false});
+            auto cur = pageStack.back();
+            pageStack.pop_back();
+            cancelBuild(cur.page);
+            leavePage(cur.page);
+            destroyPage(cur.name, cur.page);
+        }
+        lv_obj_t* page = acquirePage(name);
+        pageStack.push_back({name, page, false});
         lv_screen_load(page);
+        enterPage(page);
     }
 }
 
 // 跳转到指定页面，销毁当前页面（有动画）
 void PageManager::gotoPageAndDestroy(const std::string& name, lv_screen_load_anim_t anim_type, uint32_t time) {
+    TRACE_SCOPE("PageManager::gotoPageAndDestroy");
     if(pageFactories.count(name)) {
-        lv_obj_t* page = pageFactories[name]();
+        recordTransition(name);
+        relieveMemoryPressure();
+        // 先释放当前页面再创建新页面，销毁队列会等待切换动画结束后再删除页面
         if(!pageStack.empty()) {
-            auto cur = pageStack.top();
-            pageStack.pop();
-            lv_timer_t* timer = (lv_timer_t*)lv_obj_get_user_data(cur.page);
-                if (timer) lv_timer_del(timer);
+            auto cur = pageStack.back();
+            pageStack.pop_back();
+            cancelBuild(cur.page);
+            leavePage(cur.page);
+            destroyPage(cur.name, cur.page);
         }
-        pageStack.push({name, page, false});
-        lv_screen_load_anim(page, anim_type, time, 0, true);
+        lv_obj_t* page = acquirePage(name);
+        pageStack.push_back({name, page, false});
+        lv_screen_load_anim(page, anim_type, time, 0, false);
+        enterPage(page);
     }
 }
 
 
-// 返回上一页面，销毁当前页面（如未保留），无动画
+// 返回上一页面，当前页面放入缓存或销毁，无动画
 void PageManager::back() {
+    TRACE_SCOPE("PageManager::back");
     if(pageStack.size() > 1) {
-        auto cur = pageStack.top();
-        pageStack.pop();
-        if(!pageStack.empty() && pageStack.top().page){
-        lv_screen_load(pageStack.top().page);
-        if(!cur.keep && cur.page) {
-            // 异步安全销毁页面
-            lv_async_call([](void* obj){
-                lv_obj_t* page = static_cast<lv_obj_t*>(obj);
-                // 在此处添加自定义清理逻辑，如移除子控件、解绑事件等
-                lv_timer_t* timer = (lv_timer_t*)lv_obj_get_user_data(page);
-                if (timer) lv_timer_del(timer); // 删除定时器
-                lv_obj_clean(page); // 清理内容
-                lv_obj_del(page);  // 删除页面
-            }, cur.page);
-        }}
-
+        lastNavTick = lv_tick_get();
+        auto cur = pageStack.back();
+        pageStack.pop_back();
+        if(!pageStack.empty() && !pageStack.back().page) revivePage(pageStack.back());
+        if(!pageStack.empty() && pageStack.back().page) {
+            lv_screen_load(pageStack.back().page);
+            leavePage(cur.page);
+            // 未构建完成的页面不缓存
+            if(cur.page && (cancelBuild(cur.page) || !cachePage(cur.name, cur.page))) {
+                destroyPage(cur.name, cur.page);
+            }
+            resumePage(pageStack.back().page);
+        }
     }
 }
 
 
 // 返回上一页面，带动画，增加空指针保护
 void PageManager::back(lv_screen_load_anim_t anim_type, uint32_t time) {
+    TRACE_SCOPE("PageManager::back");
     if(pageStack.size() > 1) {
-        auto cur = pageStack.top();
-        pageStack.pop();
+        lastNavTick = lv_tick_get();
+        auto cur = pageStack.back();
+        pageStack.pop_back();
+        if(!pageStack.empty() && !pageStack.back().page) revivePage(pageStack.back());
 
-        if(!pageStack.empty() && pageStack.top().page){
-            lv_timer_t* timer = (lv_timer_t*)lv_obj_get_user_data(cur.page);
-            if (timer) lv_timer_del(timer);
-            lv_screen_load_anim(pageStack.top().page, anim_type, time, 0, !cur.keep);
+        if(!pageStack.empty() && pageStack.back().page){
+            leavePage(cur.page);
+            // 未构建完成的页面不缓存
+            bool cached = !cancelBuild(cur.page) && cachePage(cur.name, cur.page);
+            if(!cached) {
+                // 销毁队列会等待切换动画结束后再删除页面
+                destroyPage(cur.name, cur.page);
+            }
+            lv_screen_load_anim(pageStack.back().page, anim_type, time, 0, false);
+            resumePage(pageStack.back().page);
         }
     }
 }
@@ -111,15 +450,358 @@ void PageManager::back(lv_screen_load_anim_t anim_type, uint32_t time) {
 
 // 销毁所有页面，释放资源
 void PageManager::clear() {
+    pendingBuilds.clear();
+    if(prefetchBuild) {
+        lv_obj_t* page = prefetchBuild->page;
+        prefetchBuild.reset();
+        forgetPage(page);
+        lv_obj_del(page);
+    }
     while(!pageStack.empty()) {
-        auto cur = pageStack.top();
-        pageStack.pop();
-        if(cur.page) lv_obj_del(cur.page);
+        auto cur = pageStack.back();
+        pageStack.pop_back();
+        if(cur.page) {
+            leavePage(cur.page);
+            forgetPage(cur.page);
+            lv_obj_del(cur.page);
+        }
     }
+    clearCache();
+    flushTeardown();
 }
 
 
 // 获取当前页面名称
 std::string PageManager::currentPage() const {
-    return pageStack.empty() ? "" : pageStack.top().name;
+    return pageStack.empty() ? "" : pageStack.back().name;
+}
+
+
+// 获取已注册的页面名称
+std::vector<std::string> PageManager::pageNames() const {
+    std::vector<std::string> names;
+    for(const auto& kv : pageFactories) names.push_back(kv.first);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+
+// 设置缓存内存预算（字节），超出部分立即淘汰；0表示关闭缓存
+void PageManager::setCacheBudget(size_t bytes) {
+    cacheBudget = bytes;
+    prefetchRejected.clear();
+    evictCache(bytes);
+}
+
+
+// 获取缓存统计信息
+PageManager::CacheStats PageManager::getCacheStats() const {
+    return {cacheHits, cacheMisses, cacheEvictions, cacheUsed, cacheBudget, pageCache.size(), cachePrefetches,
+            pressureEvictions, pageRestores};
+}
+
+
+// 打印缓存统计信息
+void PageManager::logCacheStats() const {
+    uint32_t total = cacheHits + cacheMisses;
+    ESP_LOGI(TAG, "Page cache: %u hits, %u misses (%.1f%% hit rate), %u evictions, %u prefetches, %u/%u bytes, %u pages",
+             (unsigned)cacheHits, (unsigned)cacheMisses,
+             total ? cacheHits * 100.0f / total : 0.0f,
+             (unsigned)cacheEvictions, (unsigned)cachePrefetches,
+             (unsigned)cacheUsed, (unsigned)cacheBudget, (unsigned)pageCache.size());
+    ESP_LOGI(TAG, "Memory pressure: %u stack pages evicted, %u restored",
+             (unsigned)pressureEvictions, (unsigned)pageRestores);
+}
+
+
+// 销毁所有缓存页面
+void PageManager::clearCache() {
+    evictCache(0);
+}
+
+
+// 设置内存压力阈值（LVGL堆使用率百分比）
+void PageManager::setMemoryPressure(uint8_t high_pct, uint8_t low_pct) {
+    pressureHighPct = high_pct;
+    pressureLowPct = low_pct < high_pct ? low_pct : high_pct;
+}
+
+
+// 堆使用率超过高水位时先清空页面缓存，再释放被覆盖的页面栈页面（从栈底开始），
+// 直到低于低水位；释放需要立即生效，因此同步完成销毁队列
+bool PageManager::relieveMemoryPressure() {
+    if(heap_used_pct() < pressureHighPct) return false;
+    uint8_t before = heap_used_pct();
+    uint32_t freed = 0;
+
+    if(!pageCache.empty()) {
+        freed += pageCache.size();
+        clearCache();
+        flushTeardown();
+    }
+
+    for(size_t i = 0; i + 1 < pageStack.size() && heap_used_pct() >= pressureLowPct; i++) {
+        PageInfo& info = pageStack[i];
+        if(!info.page) continue;
+        auto fit = pageFactories.find(info.name);
+        if(fit == pageFactories.end() || !fit->second.cacheable) continue;
+        // 同名页面在栈中有多个实例时共用静态控件指针，不能单独重建
+        size_t same = 0;
+        for(const auto& other : pageStack) {
+            if(other.name == info.name) same++;
+        }
+        if(same > 1) continue;
+
+        info.state = PageState();
+        if(fit->second.hooks.onSave) fit->second.hooks.onSave(info.page, info.state);
+        cancelBuild(info.page);
+        destroyPage(info.name, info.page);
+        flushTeardown();
+        info.page = nullptr;
+        pressureEvictions++;
+        freed++;
+        ESP_LOGI(TAG, "Memory pressure: evicted %s", info.name.c_str());
+    }
+
+    // 没有可释放的页面时返回false，避免主循环空转
+    if(freed == 0) return false;
+    ESP_LOGW(TAG, "Memory pressure: heap %u%% -> %u%%, %u pages released",
+             (unsigned)before, (unsigned)heap_used_pct(), (unsigned)freed);
+    return true;
+}
+
+
+// 从状态快照重建页面栈中被销毁的页面
+void PageManager::revivePage(PageInfo& info) {
+    info.page = buildPage(info.name, true, &info.state);
+    pageRestores++;
+    ESP_LOGI(TAG, "Restored: %s", info.name.c_str());
+}
+
+
+// 页面是否在页面栈中（栈中页面的静态控件指针仍在使用，不能再构建同名页面）
+bool PageManager::isInStack(const std::string& name) const {
+    for(const auto& info : pageStack) {
+        if(info.name == name) return true;
+    }
+    return false;
+}
+
+
+// 记录从当前页面到目标页面的一次跳转
+void PageManager::recordTransition(const std::string& to) {
+    lastNavTick = lv_tick_get();
+    if(!pageStack.empty()) {
+        transitions[pageStack.back().name][to]++;
+    }
+}
+
+
+// 预测from页面之后最常访问的页面
+std::string PageManager::predictNext(const std::string& from) const {
+    auto it = transitions.find(from);
+    if(it == transitions.end()) return "";
+
+    std::string best;
+    uint32_t best_count = 0;
+    for(const auto& kv : it->second) {
+        if(kv.second > best_count) {
+            best = kv.first;
+            best_count = kv.second;
+        }
+    }
+    return best;
+}
+
+
+// 开始预取页面：工厂函数创建骨架后立即暂停页面（页面定时器和订阅随缓存一起暂停），
+// 延后的步骤在预算内执行，剩余部分由之后的runIdleTask继续
+bool PageManager::prefetch(const std::string& name, uint32_t budget_us) {
+    auto fit = pageFactories.find(name);
+    if(fit == pageFactories.end() || !fit->second.cacheable || cacheBudget == 0) return false;
+    if(prefetchBuild || pageCache.count(name) || isInStack(name)) return false;
+    // 同名旧页面仍在屏幕上等待删除时不预取，等切换动画结束后再构建
+    if(teardownPending(name)) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t before = heap_used_bytes();
+    PageBuilder builder;
+    lv_obj_t* page = startBuild(name, builder, nullptr);
+    if(!page) return false;
+    // 之后的构建步骤创建的作用域定时器同样处于暂停状态
+    pausePage(page);
+    prefetchBuild = PendingBuild{name, page, std::move(builder), before};
+
+    uint32_t used = elapsed_us(start);
+    if(used < budget_us) advancePrefetch(budget_us - used);
+    return true;
+}
+
+
+// 在预算内推进预取页面的构建步骤（至少执行一步），完成后放入缓存；构建完成返回true
+bool PageManager::advancePrefetch(uint32_t budget_us) {
+    if(!prefetchBuild->builder.run(budget_us)) return false;
+
+    std::string name = prefetchBuild->name;
+    lv_obj_t* page = prefetchBuild->page;
+    // 跨空闲间隙构建期间的其他分配也会计入，结果为近似值
+    size_t after = heap_used_bytes();
+    pageSizes[name] = after > prefetchBuild->heap_before ? after - prefetchBuild->heap_before : 0;
+    prefetchBuild.reset();
+
+    // 最后一步可能启动了服务，再通知一次暂停
+    const PageHooks* hooks = hooksOf(page);
+    if(hooks && hooks->onPause) hooks->onPause(page);
+
+    if(!cachePage(name, page)) {
+        // 页面超出缓存预算，记录下来避免空闲时反复构建
+        prefetchRejected[name] = cacheBudget;
+        destroyPage(name, page);
+        return true;
+    }
+
+    cachePrefetches++;
+    ESP_LOGD(TAG, "Prefetched: %s (%u bytes)", name.c_str(), (unsigned)pageSizes[name]);
+    return true;
+}
+
+
+// 主循环空闲时预取预测的下一页面，构建步骤只在空闲间隙（idle_ms）内推进
+bool PageManager::runIdleTask(uint32_t idle_ms) {
+    if(idle_ms < PREFETCH_MIN_IDLE_MS || pageStack.empty()) return false;
+    // 堆使用率需要遍历LVGL堆，按固定间隔检查；跳转时gotoPage会另外检查
+    if(lv_tick_elaps(lastPressureCheck) >= PRESSURE_CHECK_MS) {
+        lastPressureCheck = lv_tick_get();
+        if(relieveMemoryPressure()) return true;
+    }
+    // 跳转或返回后先等待切换动画结束
+    if(lv_tick_elaps(lastNavTick) < PREFETCH_SETTLE_MS) return false;
+
+    uint32_t budget_us = idle_ms * 1000;
+    if(prefetchBuild) {
+        advancePrefetch(budget_us);
+        return true;
+    }
+
+    std::string next = predictNext(pageStack.back().name);
+    if(next.empty() || pageCache.count(next) || isInStack(next)) return false;
+
+    auto rej = prefetchRejected.find(next);
+    if(rej != prefetchRejected.end() && rej->second == cacheBudget) return false;
+
+    return prefetch(next, budget_us);
+}
+
+
+// 页面进入销毁队列：先释放定时器和订阅，控件在后续帧中分批删除
+void PageManager::destroyPage(const std::string& name, lv_obj_t* page) {
+    forgetPage(page);
+    if(PageScope* scope = PageScope::find(page)) scope->release();
+
+    teardownQueue.push_back({name, page, heap_used_bytes(), 0, 0});
+    if(!teardownTimer) {
+        teardownTimer = lv_timer_create([](lv_timer_t* t) {
+            static_cast<PageManager*>(lv_timer_get_user_data(t))->runTeardown();
+        }, LV_DEF_REFR_PERIOD, this);
+    } else {
+        lv_timer_resume(teardownTimer);
+    }
+}
+
+
+// 在预算内删除页面的控件，每次删除页面的最后一个顶层子控件（连同其子树），页面本身最后删除
+// 不拆开顶层控件内部，图表、列表、消息框等复合控件总是整体删除
+bool PageManager::teardownStep(TeardownJob& job, uint32_t budget_us) {
+    auto start = std::chrono::steady_clock::now();
+    job.frames++;
+    while(true) {
+        bool last = lv_obj_get_child_count(job.page) == 0;
+        lv_obj_del(last ? job.page : lv_obj_get_child(job.page, -1));
+        if(last || elapsed_us(start) >= budget_us) {
+            job.time_us += elapsed_us(start);
+            return last;
+        }
+    }
+}
+
+
+// 页面销毁完成，记录耗时和释放的内存
+void PageManager::finishTeardownJob(const TeardownJob& job) {
+    size_t after = heap_used_bytes();
+    TeardownStats stats = {job.name, job.time_us, job.frames,
+                           job.heap_before > after ? job.heap_before - after : 0};
+    ESP_LOGI(TAG, "Teardown %s: %u us over %u frames, %u bytes freed",
+             stats.name.c_str(), (unsigned)stats.time_us, (unsigned)stats.frames, (unsigned)stats.freed_bytes);
+
+    teardownHistory.push_back(stats);
+    if(teardownHistory.size() > TEARDOWN_HISTORY_SIZE) teardownHistory.pop_front();
+}
+
+
+// 销毁定时器回调：按入队顺序推进，仍在显示或参与切换动画的页面等待下一帧
+void PageManager::runTeardown() {
+    TRACE_SCOPE("PageManager::runTeardown");
+    auto start = std::chrono::steady_clock::now();
+    while(!teardownQueue.empty()) {
+        TeardownJob& job = teardownQueue.front();
+        if(onScreen(job.page)) break;
+
+        uint32_t used = elapsed_us(start);
+        if(used >= teardownBudgetUs) break;
+        if(!teardownStep(job, teardownBudgetUs - used)) break;
+
+        finishTeardownJob(job);
+        teardownQueue.pop_front();
+    }
+    if(teardownQueue.empty()) lv_timer_pause(teardownTimer);
+}
+
+
+// 页面仍在显示或正参与切换动画（作为切换前的屏幕），此时不能删除
+bool PageManager::onScreen(lv_obj_t* page) const {
+    return page == lv_screen_active() || page == lv_display_get_screen_prev(NULL);
+}
+
+
+// 是否有名为name的页面仍在销毁队列中
+bool PageManager::teardownPending(const std::string& name) const {
+    for(const auto& job : teardownQueue) {
+        if(job.name == name) return true;
+    }
+    return false;
+}
+
+
+// 立即删除名为name的待销毁页面；仍在屏幕上的页面留给销毁定时器
+void PageManager::finishTeardown(const std::string& name) {
+    for(auto it = teardownQueue.begin(); it != teardownQueue.end();) {
+        if(it->name == name && !onScreen(it->page)) {
+            teardownStep(*it, UINT32_MAX);
+            finishTeardownJob(*it);
+            it = teardownQueue.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+
+// 立即删除所有待销毁页面；仍在屏幕上的页面留给销毁定时器
+void PageManager::flushTeardown() {
+    for(auto it = teardownQueue.begin(); it != teardownQueue.end();) {
+        if(onScreen(it->page)) {
+            ++it;
+            continue;
+        }
+        teardownStep(*it, UINT32_MAX);
+        finishTeardownJob(*it);
+        it = teardownQueue.erase(it);
+    }
+    if(teardownQueue.empty() && teardownTimer) lv_timer_pause(teardownTimer);
+}
+
+
+// 设置每帧用于删除页面控件的时间预算（微秒）
+void PageManager::setTeardownBudget(uint32_t budget_us) {
+    teardownBudgetUs = budget_us;
 }
@@ -1,17 +1,88 @@
 // page_manager.h
 #pragma once
 #include "lvgl/lvgl.h"
-#include <stack>
+#include <vector>
+#include <list>
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <deque>
+#include <optional>
+
+
+// 分步构建页面：工厂函数先创建页面骨架，其余区域通过defer()延后到后续帧执行
+class PageBuilder {
+public:
+    using Step = std::function<void()>;
+
+    // 追加一个构建步骤，按追加顺序执行
+    void defer(Step step);
+    bool done() const { return steps.empty(); }
+    // 执行步骤直到用完时间预算（至少执行一步），全部完成返回true
+    bool run(uint32_t budget_us);
+    // 一次性执行剩余全部步骤
+    void runAll();
+    // 丢弃未执行的步骤（页面在构建完成前被销毁）
+    void cancel() { steps.clear(); }
+private:
+    std::deque<Step> steps;
+};
+
+
+// 页面逻辑状态快照：内存紧张时页面被销毁前保存，重新访问时用于恢复
+struct PageState {
+    int32_t scroll_y = 0;           // 主滚动容器的垂直滚动位置
+    int32_t selected = -1;          // 选中的标签页或条目
+    std::string path;               // 当前路径等文本状态
+    std::vector<int32_t> data;      // 图表历史等数值状态
+};
+
+
+// 页面生命周期回调，参数为页面屏幕对象；未设置的回调不调用
+// 通过PageScope创建的定时器和可暂停订阅由管理器在暂停/恢复时自动处理，回调只需处理其他资源
+struct PageHooks {
+    std::function<void(lv_obj_t*)> onEnter;     // 页面被跳转进入（新建或从缓存取出）
+    std::function<void(lv_obj_t*)> onLeave;     // 页面离开页面栈（之后被缓存或销毁）
+    std::function<void(lv_obj_t*)> onPause;     // 页面不再可见（被覆盖、离开或进入缓存）
+    std::function<void(lv_obj_t*)> onResume;    // 暂停后的页面重新可见
+    std::function<void(lv_obj_t*, PageState&)> onSave;           // 内存紧张销毁页面前保存状态
+    std::function<void(lv_obj_t*, const PageState&)> onRestore;  // 重建页面后恢复状态（在全部构建步骤之后执行）
+};
 
 
 class PageManager {
 public:
     using PageCreateFunc = std::function<lv_obj_t*()>;
+    using PageBuildFunc = std::function<lv_obj_t*(PageBuilder&)>;
+
+    // 页面缓存统计信息
+    struct CacheStats {
+        uint32_t hits;          // 命中次数（直接复用缓存页面）
+        uint32_t misses;        // 未命中次数（调用工厂函数重建）
+        uint32_t evictions;     // 因超出预算被淘汰的页面数
+        size_t used_bytes;      // 缓存页面占用的LVGL堆内存估算值
+        size_t budget_bytes;    // 缓存内存预算
+        size_t entries;         // 当前缓存页面数
+        uint32_t prefetches;    // 空闲时预取构建的页面数
+        uint32_t pressure_evictions;    // 内存紧张时销毁的页面栈页面数
+        uint32_t restores;              // 从状态快照重建的页面数
+    };
+
+    // 单个页面的销毁统计
+    struct TeardownStats {
+        std::string name;
+        uint32_t time_us;       // 删除控件累计耗时
+        uint32_t frames;        // 分摊的帧数
+        size_t freed_bytes;     // 释放的LVGL堆内存（跨帧测量，为近似值）
+    };
 
-    void registerPage(const std::string& name, PageCreateFunc func);
+    // cacheable为false的页面离开后直接销毁，不进入缓存
+    void registerPage(const std::string& name, PageCreateFunc func, bool cacheable = true);
+    // 分步构建的页面：跳转时先显示骨架，剩余步骤每帧在构建预算内执行
+    void registerPage(const std::string& name, PageBuildFunc func, bool cacheable = true);
+    // 带生命周期回调的页面
+    void registerPage(const std::string& name, PageCreateFunc func, PageHooks hooks, bool cacheable = true);
+    void registerPage(const std::string& name, PageBuildFunc func, PageHooks hooks, bool cacheable = true);
     // 普通切换
     void gotoPage(const std::string& name);
     // 带动画切换
@@ -26,12 +97,149 @@ public:
 
     void clear();
     std::string currentPage() const;
+    // 已注册的页面名称（按名称排序）
+    std::vector<std::string> pageNames() const;
+
+    // 页面缓存（LRU，按页面名索引，内存通过lv_mem_monitor测量）
+    void setCacheBudget(size_t bytes);
+    CacheStats getCacheStats() const;
+    void logCacheStats() const;
+    void clearCache();
+
+    // 预取：提前构建页面并放入缓存，之后的gotoPage只需切换屏幕
+    // 工厂函数创建骨架后，延后的步骤只在budget_us内执行，剩余步骤由之后的runIdleTask继续；开始预取返回true
+    bool prefetch(const std::string& name, uint32_t budget_us = UINT32_MAX);
+    // 根据导航历史预测当前页面之后最可能访问的页面，无预测时返回空字符串
+    std::string predictNext(const std::string& from) const;
+    // 在主循环空闲间隙调用，idle_ms为距离下一个LVGL定时器的时间，预取的构建步骤不超过这段时间；执行了工作返回true
+    bool runIdleTask(uint32_t idle_ms);
+
+    // 内存压力：LVGL堆使用率达到high_pct时销毁缓存页面和被覆盖的页面，直到低于low_pct
+    void setMemoryPressure(uint8_t high_pct, uint8_t low_pct);
+    // 检查内存压力并释放页面，释放了页面返回true
+    bool relieveMemoryPressure();
+
+    // 分步构建每帧可占用的时间（微秒），0表示跳转时一次性构建完成
+    void setBuildBudget(uint32_t budget_us);
+    // 是否还有页面未构建完成
+    bool isBuilding() const { return !pendingBuilds.empty(); }
+
+    // 页面销毁队列：控件在切换动画结束后分多帧删除，每帧不超过预算（微秒）
+    void setTeardownBudget(uint32_t budget_us);
+    // 最近完成的页面销毁记录（最多16条）
+    const std::deque<TeardownStats>& getTeardownStats() const { return teardownHistory; }
+    // 立即删除所有待销毁页面（仍在显示或参与切换动画的页面除外）
+    void flushTeardown();
 private:
     struct PageInfo {
         std::string name;
-        lv_obj_t* page;
+        lv_obj_t* page;         // 因内存紧张被销毁时为nullptr，返回时从state重建
         bool keep;
+        PageState state;
+    };
+    struct PageEntry {
+        PageBuildFunc build;
+        bool cacheable;
+        PageHooks hooks;
+    };
+    // 已构建页面的运行状态
+    struct PageRuntime {
+        std::string name;
+        bool paused;
     };
-    std::stack<PageInfo> pageStack;
-    std::unordered_map<std::string, PageCreateFunc> pageFactories;
+    struct PendingBuild {
+        std::string name;
+        lv_obj_t* page;
+        PageBuilder builder;
+        size_t heap_before;     // 开始构建时的堆占用，构建完成后计算页面内存
+    };
+    struct TeardownJob {
+        std::string name;
+        lv_obj_t* page;
+        size_t heap_before;
+        uint32_t time_us;
+        uint32_t frames;
+    };
+    struct CacheEntry {
+        lv_obj_t* page;
+        size_t bytes;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    // 从缓存取出页面，未命中时调用工厂函数并记录页面内存占用
+    lv_obj_t* acquirePage(const std::string& name);
+    // 页面离开页面栈：可缓存则放入缓存，否则返回false由调用方销毁
+    bool cachePage(const std::string& name, lv_obj_t* page);
+    // 淘汰最久未使用的页面直到满足预算
+    void evictCache(size_t budget);
+    // 调用工厂函数构建页面并记录内存占用；incremental为true时剩余步骤交给构建定时器
+    // restore不为空时在构建步骤最后调用onRestore
+    lv_obj_t* buildPage(const std::string& name, bool incremental = false, const PageState* restore = nullptr);
+    lv_obj_t* startBuild(const std::string& name, PageBuilder& builder, const PageState* restore);
+    void queueBuild(PendingBuild pb);
+    // 在预算内推进空闲预取的页面，构建完成后放入缓存
+    bool advancePrefetch(uint32_t budget_us);
+    // 重建因内存紧张被销毁的页面栈页面
+    void revivePage(PageInfo& info);
+    // 页面构建未完成时丢弃剩余步骤，返回页面是否处于构建中
+    bool cancelBuild(lv_obj_t* page);
+    // 构建定时器回调：在预算内推进待构建页面
+    void runPendingBuilds();
+
+    // 生命周期：暂停/恢复页面定时器并调用对应回调
+    void pausePage(lv_obj_t* page);
+    void resumePage(lv_obj_t* page);
+    void enterPage(lv_obj_t* page);
+    void leavePage(lv_obj_t* page);
+    // 页面即将销毁，移除运行状态
+    void forgetPage(lv_obj_t* page);
+    const PageHooks* hooksOf(lv_obj_t* page) const;
+
+    // 销毁页面：释放页面资源后放入销毁队列
+    void destroyPage(const std::string& name, lv_obj_t* page);
+    // 执行一次删除步骤，页面删除完成返回true
+    bool teardownStep(TeardownJob& job, uint32_t budget_us);
+    void finishTeardownJob(const TeardownJob& job);
+    void runTeardown();
+    void finishTeardown(const std::string& name);
+    bool teardownPending(const std::string& name) const;
+    bool onScreen(lv_obj_t* page) const;
+    // 记录一次页面跳转，用于预测
+    void recordTransition(const std::string& to);
+    bool isInStack(const std::string& name) const;
+
+    std::vector<PageInfo> pageStack;
+    std::unordered_map<std::string, PageEntry> pageFactories;
+
+    std::list<std::string> cacheLru;                          // 头部为最近使用
+    std::unordered_map<std::string, CacheEntry> pageCache;
+    std::unordered_map<std::string, size_t> pageSizes;        // 每个页面最近一次构建的内存占用
+    size_t cacheBudget = 256 * 1024;
+    size_t cacheUsed = 0;
+    uint32_t cacheHits = 0;
+    uint32_t cacheMisses = 0;
+    uint32_t cacheEvictions = 0;
+    uint32_t cachePrefetches = 0;
+    uint32_t pressureEvictions = 0;
+    uint32_t pageRestores = 0;
+    uint8_t pressureHighPct = 85;
+    uint8_t pressureLowPct = 70;
+
+    // 导航历史：from -> (to -> 次数)
+    std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> transitions;
+    std::unordered_map<std::string, uint32_t> prefetchRejected;   // 预取后无法缓存的页面（记录当时的预算）
+    uint32_t lastNavTick = 0;
+    uint32_t lastPressureCheck = 0;
+    std::optional<PendingBuild> prefetchBuild;    // 正在空闲时构建的预取页面（尚未放入缓存）
+
+    std::unordered_map<lv_obj_t*, PageRuntime> pageRuntime;
+
+    std::vector<PendingBuild> pendingBuilds;
+    lv_timer_t* buildTimer = nullptr;
+    uint32_t buildBudgetUs = 4000;
+
+    std::deque<TeardownJob> teardownQueue;
+    std::deque<TeardownStats> teardownHistory;
+    lv_timer_t* teardownTimer = nullptr;
+    uint32_t teardownBudgetUs = 2000;
 };
@@ -1,7 +1,9 @@
 #include "system/windows_compat.h"
 #include "lvgl/lvgl.h"
 #include "page_manager.h"
+#include "page_scope.h"
 #include "pages_common.h"
+#include "label_bind.h"
 #include <iostream>
 #include <cstring>
 #include <time.h>
@@ -18,11 +20,11 @@ extern PageManager g_pageManager;
 static const char *TAG = "page_menu";
 
 // 状态栏相关的静态变量
+static lv_obj_t *menu_screen = NULL;
 static lv_obj_t *status_bar = NULL;
 static lv_obj_t *time_label = NULL;
 static lv_obj_t *battery_label = NULL;
 static lv_obj_t *wifi_label = NULL;
-static lv_timer_t *status_update_timer = NULL;
 
 // 获取电池图标
 static const char* get_battery_icon(int percentage, bool is_charging) {
@@ -76,7 +78,7 @@ static void update_status_bar(void) {
             // 时间已同步，显示当前时间
             char time_str[32];
             strftime(time_str, sizeof(time_str), "%H:%M", &timeinfo);
-            lv_label_set_text(time_label, time_str);
+            label_bind_set_text(time_label, time_str);
 
             // 只在分钟变化时输出日志
             if (current_minute != last_minute) {
@@ -85,7 +87,7 @@ static void update_status_bar(void) {
             }
         } else {
             // 时间未同步，显示未同步状态
-            lv_label_set_text(time_label, "--:--");
+            label_bind_set_text(time_label, "--:--");
 
             // 只在分钟变化时输出日志
             if (current_minute != last_minute) {
@@ -100,20 +102,19 @@ static void update_status_bar(void) {
         battery_service::BatteryInfo battery_info = battery_service::get_battery_info();
         if (battery_info.is_valid) {
             const char* battery_icon = get_battery_icon(battery_info.percentage, battery_info.is_charging);
-            lv_label_set_text_fmt(battery_label, "%s %d%%", battery_icon, battery_info.percentage);
+            label_bind_values(battery_label, 1.0f, "%s %d%%", battery_icon, battery_info.percentage);
         } else {
-            lv_label_set_text(battery_label, LV_SYMBOL_BATTERY_EMPTY " --%");
+            label_bind_set_text(battery_label, LV_SYMBOL_BATTERY_EMPTY " --%");
         }
     }
 
     // 更新WiFi状态
     if (wifi_label) {
-        if (wifi_manager_is_connected()) {
-            lv_label_set_text(wifi_label, LV_SYMBOL_WIFI);
-            lv_obj_set_style_text_color(wifi_label, lv_color_hex(0x4CAF50), 0); // 绿色表示连接
-        } else {
-            lv_label_set_text(wifi_label, LV_SYMBOL_WIFI);
-            lv_obj_set_style_text_color(wifi_label, lv_color_hex(0x666666), 0); // 灰色表示未连接
+        // 绿色表示连接，灰色表示未连接；设置样式也会重绘，颜色不变时跳过
+        lv_color_t color = wifi_manager_is_connected() ? lv_color_hex(0x4CAF50) : lv_color_hex(0x666666);
+        label_bind_set_text(wifi_label, LV_SYMBOL_WIFI);
+        if (!lv_color_eq(lv_obj_get_style_text_color(wifi_label, LV_PART_MAIN), color)) {
+            lv_obj_set_style_text_color(wifi_label, color, 0);
         }
     }
 }
@@ -246,27 +247,18 @@ static const MenuItem menu_items[] = {
 static void menu_event_handler(lv_event_t *e) {
     const MenuItem *item = (const MenuItem *)lv_event_get_user_data(e);
      if (item && item->action) {
-    //     // 在离开页面前清理资源
-    //     if (status_update_timer) {
-    //         lv_timer_del(status_update_timer);
-    //         status_update_timer = NULL;
-    //         ESP_LOGI(TAG, "Menu status update timer stopped");
-    //     }
-
         item->action(e); // 调用对应的函数指针
     }
 }
 
-// 页面清理函数（当页面被销毁时调用）
-void cleanup_menu_page(void) {
+// 页面删除时重置静态变量（定时器由页面资源作用域释放）
+static void menu_page_delete_cb(lv_event_t *e) {
+    // 同名新页面可能在旧页面删除前创建，静态变量已属于新页面时不重置
+    if (lv_event_get_target(e) != menu_screen) return;
     ESP_LOGI(TAG, "Cleaning up menu page");
 
-    if (status_update_timer) {
-        lv_timer_del(status_update_timer);
-        status_update_timer = NULL;
-    }
-
     // 重置静态变量
+    menu_screen = NULL;
     status_bar = NULL;
     time_label = NULL;
     battery_label = NULL;
@@ -276,10 +268,13 @@ void cleanup_menu_page(void) {
 }
 
 lv_obj_t* createPage_menu(){
+    TRACE_FUNC();
     ESP_LOGI(TAG, "Creating menu page with status bar");
 
     lv_obj_t *main_screen = lv_obj_create(NULL);
+    menu_screen = main_screen;
     lv_obj_set_style_bg_color(main_screen, lv_color_hex(0xF0F0F0), 0);
+    lv_obj_add_event_cb(main_screen, menu_page_delete_cb, LV_EVENT_DELETE, NULL);
 
     // 创建状态栏
     status_bar = create_status_bar(main_screen);
@@ -330,7 +325,7 @@ lv_obj_t* createPage_menu(){
     update_status_bar();
 
     // 启动定时器，每秒更新状态栏
-    status_update_timer = lv_timer_create(status_update_timer_cb, 1000, NULL);
+    PageScope::of(main_screen).createTimer(status_update_timer_cb, 1000, NULL);
 
     ESP_LOGI(TAG, "Menu page created with status bar and update timer");
 
@@ -1,11 +1,14 @@
 #include "lvgl/lvgl.h"
 #include "page_manager.h"
+#include "page_scope.h"
 #include "pages_common.h"
+#include "label_bind.h"
 #include "system/mpu6050_service.h"
 #include "system/esp_log.h"
 #include "system/windows_compat.h"
 #include "system/esp_err_to_name.h"
 #include <cmath>
+#include <algorithm>
 
 extern PageManager g_pageManager;
 
@@ -37,6 +40,8 @@ static lv_obj_t* g_orientation_label = NULL;
 // 定时器和数据
 static lv_timer_t* g_update_timer = NULL;
 static mpu6050_data_t g_last_data = {0};
+// 服务已在页面构建的最后一步初始化成功（构建未完成或初始化失败时为false）
+static bool g_service_ready = false;
 
 // 前向声明
 static void mpu6050_data_callback(const mpu6050_data_t* data);
@@ -47,6 +52,7 @@ static void create_status_section(lv_obj_t* parent);
 static void create_charts_section(lv_obj_t* parent);
 static void create_orientation_section(lv_obj_t* parent);
 static void create_control_buttons(lv_obj_t* parent);
+static void start_page_updates(void);
 
 // 数据更新回调函数
 static void mpu6050_data_callback(const mpu6050_data_t* data)
@@ -67,50 +73,34 @@ static void update_ui_timer_cb(lv_timer_t* timer)
 
     if (!g_last_data.is_valid) {
         // 即使数据无效，也显示连接状态
-        if (g_status_label) {
-            lv_label_set_text(g_status_label, LV_SYMBOL_CLOSE " No Data");
-        }
-        if (g_temp_label) {
-            lv_label_set_text(g_temp_label, LV_SYMBOL_EYE_OPEN " Temperature: --°C");
-        }
-        if (g_accel_values_label) {
-            lv_label_set_text(g_accel_values_label, "X: ------ g\nY: ------ g\nZ: ------ g");
-        }
-        if (g_gyro_values_label) {
-            lv_label_set_text(g_gyro_values_label, "X: ------ °/s\nY: ------ °/s\nZ: ------ °/s");
-        }
-        if (g_orientation_label) {
-            lv_label_set_text(g_orientation_label, "Roll:  ------°\nPitch: ------°");
-        }
+        // 内容不变时不重绘（见label_bind.h）
+        label_bind_set_text(g_status_label, LV_SYMBOL_CLOSE " No Data");
+        label_bind_set_text(g_temp_label, LV_SYMBOL_EYE_OPEN " Temperature: --°C");
+        label_bind_set_text(g_accel_values_label, "X: ------ g\nY: ------ g\nZ: ------ g");
+        label_bind_set_text(g_gyro_values_label, "X: ------ °/s\nY: ------ °/s\nZ: ------ °/s");
+        label_bind_set_text(g_orientation_label, "Roll:  ------°\nPitch: ------°");
         return;
     }
 
+    // 以下标签按显示精度绑定数值，数值在精度内未变化时不格式化也不重绘
     // 更新状态信息
-    if (g_status_label) {
-        lv_label_set_text_fmt(g_status_label,
-            LV_SYMBOL_WIFI " Connected  " LV_SYMBOL_REFRESH " %.1f Hz",
-            1000.0f / 50.0f); // 假设50ms更新间隔
-    }
+    label_bind_values(g_status_label, 0.1f,
+        LV_SYMBOL_WIFI " Connected  " LV_SYMBOL_REFRESH " %.1f Hz",
+        1000.0f / 50.0f); // 假设50ms更新间隔
 
     // 更新温度显示
-    if (g_temp_label) {
-        lv_label_set_text_fmt(g_temp_label,
-            LV_SYMBOL_EYE_OPEN " Temperature: %.1f°C", g_last_data.temperature);
-    }
+    label_bind_values(g_temp_label, 0.1f,
+        LV_SYMBOL_EYE_OPEN " Temperature: %.1f°C", g_last_data.temperature);
 
     // 更新加速度计数值显示
-    if (g_accel_values_label) {
-        lv_label_set_text_fmt(g_accel_values_label,
-            "X: %6.2f g\nY: %6.2f g\nZ: %6.2f g",
-            g_last_data.accel_x, g_last_data.accel_y, g_last_data.accel_z);
-    }
+    label_bind_values(g_accel_values_label, 0.01f,
+        "X: %6.2f g\nY: %6.2f g\nZ: %6.2f g",
+        g_last_data.accel_x, g_last_data.accel_y, g_last_data.accel_z);
 
     // 更新陀螺仪数值显示
-    if (g_gyro_values_label) {
-        lv_label_set_text_fmt(g_gyro_values_label,
-            "X: %6.1f °/s\nY: %6.1f °/s\nZ: %6.1f °/s",
-            g_last_data.gyro_x, g_last_data.gyro_y, g_last_data.gyro_z);
-    }
+    label_bind_values(g_gyro_values_label, 0.1f,
+        "X: %6.1f °/s\nY: %6.1f °/s\nZ: %6.1f °/s",
+        g_last_data.gyro_x, g_last_data.gyro_y, g_last_data.gyro_z);
 
     // 更新图表
     update_charts(&g_last_data);
@@ -144,7 +134,7 @@ static void update_orientation_display(const mpu6050_data_t* data)
     float roll = atan2(data->accel_y, data->accel_z) * 180.0f / M_PI;
     float pitch = atan2(-data->accel_x, sqrt(data->accel_y * data->accel_y + data->accel_z * data->accel_z)) * 180.0f / M_PI;
 
-    lv_label_set_text_fmt(g_orientation_label,
+    label_bind_values(g_orientation_label, 0.1f,
         "Roll:  %6.1f°\nPitch: %6.1f°", roll, pitch);
 }
 
@@ -331,38 +321,108 @@ static void create_control_buttons(lv_obj_t* parent)
 }
 
 /**
- * 创建MPU6050页面
+ * 页面不可见时停止数据采集并注销回调（UI更新定时器由PageManager暂停）
  */
-lv_obj_t* createPage_mpu6050(void)
+void pausePage_mpu6050(lv_obj_t* page)
 {
-    ESP_LOGI(TAG, "Creating MPU6050 page...");
+    LV_UNUSED(page);
+    mpu6050_service_unregister_callback();
+    mpu6050_service_stop();
+}
 
-    // 创建主屏幕
-    g_page_screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(g_page_screen, lv_color_hex(0xFAFAFA), 0);
-    lv_obj_set_style_pad_all(g_page_screen, 8, 0);
+/**
+ * 页面重新可见时恢复数据采集（服务未初始化时跳过）
+ */
+void resumePage_mpu6050(lv_obj_t* page)
+{
+    LV_UNUSED(page);
+    if (!g_service_ready) return;
+    mpu6050_service_register_callback(mpu6050_data_callback);
+    esp_err_t ret = mpu6050_service_start(50);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restart MPU6050 service: %s", esp_err_to_name(ret));
+    }
+}
 
-    // 创建滚动容器
-    lv_obj_t* scroll_cont = lv_obj_create(g_page_screen);
-    lv_obj_set_size(scroll_cont, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_border_width(scroll_cont, 0, 0);
-    lv_obj_set_style_bg_opa(scroll_cont, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_pad_all(scroll_cont, 0, 0);
-    lv_obj_set_flex_flow(scroll_cont, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(scroll_cont, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_scrollbar_mode(scroll_cont, LV_SCROLLBAR_MODE_AUTO);
+// 图表历史序列化格式：[起始点, 各数据点...]
+static void save_series(std::vector<int32_t>& out, lv_obj_t* chart, lv_chart_series_t* ser)
+{
+    uint32_t cnt = lv_chart_get_point_count(chart);
+    int32_t* ys = lv_chart_get_y_array(chart, ser);
+    out.push_back((int32_t)lv_chart_get_x_start_point(chart, ser));
+    out.insert(out.end(), ys, ys + cnt);
+}
 
-    // 创建各个区域
-    create_status_section(scroll_cont);
-    create_charts_section(scroll_cont);
-    create_orientation_section(scroll_cont);
-    create_control_buttons(scroll_cont);
+static size_t restore_series(const std::vector<int32_t>& in, size_t pos, lv_obj_t* chart, lv_chart_series_t* ser)
+{
+    uint32_t cnt = lv_chart_get_point_count(chart);
+    if (pos + 1 + cnt > in.size()) return in.size();
+    lv_chart_set_x_start_point(chart, ser, (uint32_t)in[pos]);
+    int32_t* ys = lv_chart_get_y_array(chart, ser);
+    std::copy(in.begin() + pos + 1, in.begin() + pos + 1 + cnt, ys);
+    return pos + 1 + cnt;
+}
+
+/**
+ * 内存紧张页面被销毁前保存滚动位置和图表历史
+ */
+void savePage_mpu6050(lv_obj_t* page, PageState& state)
+{
+    lv_obj_t* scroll_cont = lv_obj_get_child(page, 0);
+    if (scroll_cont) state.scroll_y = lv_obj_get_scroll_y(scroll_cont);
+
+    if (g_accel_chart && g_gyro_chart) {
+        state.data.push_back((int32_t)lv_chart_get_point_count(g_accel_chart));
+        save_series(state.data, g_accel_chart, g_accel_x_series);
+        save_series(state.data, g_accel_chart, g_accel_y_series);
+        save_series(state.data, g_accel_chart, g_accel_z_series);
+        save_series(state.data, g_gyro_chart, g_gyro_x_series);
+        save_series(state.data, g_gyro_chart, g_gyro_y_series);
+        save_series(state.data, g_gyro_chart, g_gyro_z_series);
+    }
+}
+
+/**
+ * 页面重建后恢复滚动位置和图表历史
+ */
+void restorePage_mpu6050(lv_obj_t* page, const PageState& state)
+{
+    if (g_accel_chart && g_gyro_chart && !state.data.empty() &&
+        state.data[0] == (int32_t)lv_chart_get_point_count(g_accel_chart)) {
+        size_t pos = 1;
+        pos = restore_series(state.data, pos, g_accel_chart, g_accel_x_series);
+        pos = restore_series(state.data, pos, g_accel_chart, g_accel_y_series);
+        pos = restore_series(state.data, pos, g_accel_chart, g_accel_z_series);
+        pos = restore_series(state.data, pos, g_gyro_chart, g_gyro_x_series);
+        pos = restore_series(state.data, pos, g_gyro_chart, g_gyro_y_series);
+        restore_series(state.data, pos, g_gyro_chart, g_gyro_z_series);
+        lv_chart_refresh(g_accel_chart);
+        lv_chart_refresh(g_gyro_chart);
+    }
+
+    lv_obj_t* scroll_cont = lv_obj_get_child(page, 0);
+    if (scroll_cont) {
+        lv_obj_update_layout(scroll_cont);
+        lv_obj_scroll_to_y(scroll_cont, state.scroll_y, LV_ANIM_OFF);
+    }
+}
 
+/**
+ * 启动MPU6050服务和UI更新定时器（页面构建的最后一步）
+ */
+static void start_page_updates(void)
+{
     // 初始化MPU6050服务
+    PageScope& scope = PageScope::of(g_page_screen);
     esp_err_t ret = mpu6050_service_init();
+    g_service_ready = (ret == ESP_OK);
     if (ret == ESP_OK) {
-        // 注册数据回调
+        // 注册数据回调，页面删除时注销并停止采集
         mpu6050_service_register_callback(mpu6050_data_callback);
+        scope.addSubscription([]() {
+            mpu6050_service_unregister_callback();
+            mpu6050_service_stop();
+        });
 
         // 启动数据采集（50ms间隔）
         ret = mpu6050_service_start(50);
@@ -387,7 +447,7 @@ lv_obj_t* createPage_mpu6050(void)
     }
 
     // 创建UI更新定时器
-    g_update_timer = lv_timer_create(update_ui_timer_cb, 100, NULL); // 100ms更新UI
+    g_update_timer = scope.createTimer(update_ui_timer_cb, 100, NULL); // 100ms更新UI
 
     // 立即触发一次数据更新，确保UI有初始数据
     mpu6050_data_t initial_data;
@@ -395,9 +455,43 @@ lv_obj_t* createPage_mpu6050(void)
         g_last_data = initial_data;
     }
 
-    // 设置页面用户数据，用于清理
-    lv_obj_set_user_data(g_page_screen, g_update_timer);
+    // 定时器和数据回调记录在页面资源作用域中，页面删除时统一释放
 
     ESP_LOGI(TAG, "MPU6050 page created successfully");
+}
+
+/**
+ * 创建MPU6050页面
+ */
+lv_obj_t* createPage_mpu6050(PageBuilder& builder)
+{
+    TRACE_FUNC();
+    ESP_LOGI(TAG, "Creating MPU6050 page...");
+
+    // 创建主屏幕
+    g_service_ready = false;
+    g_page_screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(g_page_screen, lv_color_hex(0xFAFAFA), 0);
+    lv_obj_set_style_pad_all(g_page_screen, 8, 0);
+
+    // 创建滚动容器
+    lv_obj_t* scroll_cont = lv_obj_create(g_page_screen);
+    lv_obj_set_size(scroll_cont, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_border_width(scroll_cont, 0, 0);
+    lv_obj_set_style_bg_opa(scroll_cont, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_pad_all(scroll_cont, 0, 0);
+    lv_obj_set_flex_flow(scroll_cont, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(scroll_cont, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_scrollbar_mode(scroll_cont, LV_SCROLLBAR_MODE_AUTO);
+
+    // 骨架：状态区域随页面一起创建，其余区域分帧构建
+    create_status_section(scroll_cont);
+    builder.defer([scroll_cont]() { create_charts_section(scroll_cont); });
+    builder.defer([scroll_cont]() { create_orientation_section(scroll_cont); });
+    builder.defer([scroll_cont]() { create_control_buttons(scroll_cont); });
+    // 所有区域创建完成后再启动服务和UI更新定时器
+    builder.defer(start_page_updates);
+
+    ESP_LOGI(TAG, "MPU6050 page skeleton created");
     return g_page_screen;
 }
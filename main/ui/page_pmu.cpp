@@ -1,5 +1,6 @@
 #include "lvgl/lvgl.h"
 #include "page_manager.h"
+#include "page_scope.h"
 #include "pages_common.h"
 #include "system/pmu_service.h"
 #include "system/esp_log.h"
@@ -32,9 +33,6 @@ static lv_obj_t *g_aldo4_switch = NULL;
 static lv_obj_t *g_bldo1_switch = NULL;
 static lv_obj_t *g_bldo2_switch = NULL;
 
-// 更新定时器
-static lv_timer_t *g_update_timer = NULL;
-
 // 数据缓存，避免在定时器回调中直接更新UI
 static pmu_data_t g_cached_pmu_data = {0};
 static bool g_data_updated = false;
@@ -486,20 +484,50 @@ static void update_ui_timer_cb(lv_timer_t *timer)
 }
 
 /**
- * @brief PMU页面删除事件回调
+ * @brief 注册数据回调并启动数据采集，更新连接状态显示
  */
-static void pmu_page_delete_cb(lv_event_t *e)
+static void start_pmu_collection(void)
 {
-    ESP_LOGI(TAG, "PMU page delete event triggered, cleaning up resources...");
+    pmu_service_register_data_callback(pmu_data_callback);
+    pmu_service_register_event_callback(pmu_event_callback);
 
-    // 停止PMU服务
-    pmu_service_stop();
+    // 启动数据采集（进一步降低频率到5秒间隔，大幅减少CPU负载）
+    esp_err_t ret = pmu_service_start(5000);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "PMU service started successfully");
 
-    // 清理定时器
-    if (g_update_timer) {
-        lv_timer_del(g_update_timer);
-        g_update_timer = NULL;
+        // 更新状态显示
+        if (g_status_label) {
+            lv_label_set_text(g_status_label, LV_SYMBOL_WIFI " PMU 已连接  " LV_SYMBOL_REFRESH " 正常运行");
+            lv_obj_set_style_text_color(g_status_label, lv_color_hex(0x00AA00), 0);
+        }
+    } else {
+        ESP_LOGE(TAG, "Failed to start PMU service: %s", esp_err_to_name(ret));
+        if (g_status_label) {
+            lv_label_set_text(g_status_label, LV_SYMBOL_WARNING " PMU 服务启动失败");
+            lv_obj_set_style_text_color(g_status_label, lv_color_hex(0xAA0000), 0);
+        }
     }
+}
+
+/**
+ * @brief 注销数据回调并停止数据采集
+ */
+static void stop_pmu_collection(void)
+{
+    pmu_service_register_data_callback(NULL);
+    pmu_service_register_event_callback(NULL);
+    pmu_service_stop();
+}
+
+/**
+ * @brief PMU页面删除事件回调（定时器和服务由页面资源作用域释放）
+ */
+static void pmu_page_delete_cb(lv_event_t *e)
+{
+    // 同名新页面可能在旧页面删除前创建，全局变量已属于新页面时不重置
+    if (lv_event_get_target(e) != g_page_screen) return;
+    g_page_screen = NULL;
 
     // 重置全局变量
     g_status_label = NULL;
@@ -528,6 +556,7 @@ static void pmu_page_delete_cb(lv_event_t *e)
  */
 lv_obj_t* createPage_pmu(void)
 {
+    TRACE_FUNC();
     ESP_LOGI(TAG, "Creating PMU page...");
 
     // 创建主屏幕
@@ -555,29 +584,11 @@ lv_obj_t* createPage_pmu(void)
     create_control_buttons(scroll_cont);
 
     // 初始化PMU服务
+    PageScope &scope = PageScope::of(g_page_screen);
     esp_err_t ret = pmu_service_init();
     if (ret == ESP_OK) {
-        // 注册数据回调
-        pmu_service_register_data_callback(pmu_data_callback);
-        pmu_service_register_event_callback(pmu_event_callback);
-
-        // 启动数据采集（进一步降低频率到5秒间隔，大幅减少CPU负载）
-        ret = pmu_service_start(5000);
-        if (ret == ESP_OK) {
-            ESP_LOGI(TAG, "PMU service started successfully");
-
-            // 更新状态显示
-            if (g_status_label) {
-                lv_label_set_text(g_status_label, LV_SYMBOL_WIFI " PMU 已连接  " LV_SYMBOL_REFRESH " 正常运行");
-                lv_obj_set_style_text_color(g_status_label, lv_color_hex(0x00AA00), 0);
-            }
-        } else {
-            ESP_LOGE(TAG, "Failed to start PMU service: %s", esp_err_to_name(ret));
-            if (g_status_label) {
-                lv_label_set_text(g_status_label, LV_SYMBOL_WARNING " PMU 服务启动失败");
-                lv_obj_set_style_text_color(g_status_label, lv_color_hex(0xAA0000), 0);
-            }
-        }
+        // 页面可见时采集数据，页面不可见或删除时注销回调并停止采集
+        scope.addSubscription(start_pmu_collection, stop_pmu_collection);
     } else {
         ESP_LOGE(TAG, "Failed to initialize PMU service: %s", esp_err_to_name(ret));
         if (g_status_label) {
@@ -587,7 +598,7 @@ lv_obj_t* createPage_pmu(void)
     }
 
     // 创建UI更新定时器（500ms更新一次UI，降低刷新频率）
-    g_update_timer = lv_timer_create(update_ui_timer_cb, 500, NULL);
+    scope.createTimer(update_ui_timer_cb, 500, NULL);
 
     ESP_LOGI(TAG, "PMU page created successfully");
     return g_page_screen;
@@ -5,6 +5,8 @@
 
 #include "pages_common.h"
 #include "page_manager.h"
+#include "page_scope.h"
+#include "label_bind.h"
 #include "pages_common.h"
 #include "system/qmc5883l_service.h"
 #include "system/esp_log.h"
@@ -19,6 +21,8 @@ static const char *TAG = "page_qmc5883l";
 // 页面对象
 static lv_obj_t *g_page_screen = NULL;
 static lv_timer_t *g_update_timer = NULL;
+// 服务已在页面构建的最后一步初始化成功（构建未完成或初始化失败时为false）
+static bool g_service_ready = false;
 
 // UI组件
 static lv_obj_t *g_status_label = NULL;
@@ -59,6 +63,7 @@ static void create_status_section(lv_obj_t *parent);
 static void create_compass_section(lv_obj_t *parent);
 static void create_data_section(lv_obj_t *parent);
 static void create_control_buttons(lv_obj_t *parent);
+static void start_page_updates(void);
 static void qmc5883l_data_callback(const qmc5883l_service_data_t *data);
 static void update_ui_timer_cb(lv_timer_t *timer);
 static void update_compass(float heading, float magnitude);
@@ -488,28 +493,17 @@ static void update_ui_timer_cb(lv_timer_t *timer)
     // 如果没有有效数据，显示"等待数据"状态
     if (!g_current_data.is_valid)
     {
-        if (g_mag_values_label)
-        {
-            lv_label_set_text(g_mag_values_label, "Waiting for\nmagnetometer\ndata...");
-        }
-        if (g_heading_label)
-        {
-            lv_label_set_text(g_heading_label, "--- N/A");
-        }
-        if (g_mag_magnitude_label)
-        {
-            lv_label_set_text(g_mag_magnitude_label, "--- mG");
-        }
+        // 内容不变时不重绘（见label_bind.h）
+        label_bind_set_text(g_mag_values_label, "Waiting for\nmagnetometer\ndata...");
+        label_bind_set_text(g_heading_label, "--- N/A");
+        label_bind_set_text(g_mag_magnitude_label, "--- mG");
         return;
     }
 
-    // 更新磁场数值显示
-    if (g_mag_values_label)
-    {
-        lv_label_set_text_fmt(g_mag_values_label,
-                              "X: %6.1f mG\nY: %6.1f mG\nZ: %6.1f mG",
-                              g_current_data.mag_x, g_current_data.mag_y, g_current_data.mag_z);
-    }
+    // 更新磁场数值显示（按显示精度绑定，数值未变化时不格式化也不重绘）
+    label_bind_values(g_mag_values_label, 0.1f,
+                      "X: %6.1f mG\nY: %6.1f mG\nZ: %6.1f mG",
+                      g_current_data.mag_x, g_current_data.mag_y, g_current_data.mag_z);
 
     // 更新航向显示
     if (g_heading_label)
@@ -534,14 +528,11 @@ static void update_ui_timer_cb(lv_timer_t *timer)
         else if (heading >= 292.5 && heading < 337.5)
             direction = "NW";
 
-        lv_label_set_text_fmt(g_heading_label, "%.1f° %s", heading, direction);
+        label_bind_values(g_heading_label, 0.1f, "%.1f° %s", heading, direction);
     }
 
     // 更新磁场强度显示
-    if (g_mag_magnitude_label)
-    {
-        lv_label_set_text_fmt(g_mag_magnitude_label, "%.1f mG", g_current_data.magnitude);
-    }
+    label_bind_values(g_mag_magnitude_label, 0.1f, "%.1f mG", g_current_data.magnitude);
 
     // 更新指南针
     if (g_compass_scale)
@@ -569,7 +560,7 @@ static void update_compass(float heading, float magnitude)
     if (g_compass_center_label)
     {
         const char *direction = heading_to_cardinal((int32_t)heading);
-        lv_label_set_text_fmt(g_compass_center_label, "%.0f°\n%s", heading, direction);
+        label_bind_values(g_compass_center_label, 1.0f, "%.0f°\n%s", heading, direction);
     }
 
     // 根据磁场强度调整指针颜色
@@ -619,39 +610,48 @@ static void update_mag_chart(const qmc5883l_service_data_t *data)
 }
 
 /**
- * 创建QMC5883L页面
+ * 页面不可见时停止数据采集并注销回调（UI更新定时器由PageManager暂停）
  */
-lv_obj_t *createPage_qmc5883l(void)
+void pausePage_qmc5883l(lv_obj_t *page)
 {
-    ESP_LOGI(TAG, "Creating QMC5883L page...");
-
-    // 创建主屏幕
-    g_page_screen = lv_obj_create(NULL);
-    lv_obj_set_style_bg_color(g_page_screen, lv_color_hex(0xFAFAFA), 0);
-    lv_obj_set_style_pad_all(g_page_screen, 8, 0);
-
-    // 创建滚动容器
-    lv_obj_t *scroll_cont = lv_obj_create(g_page_screen);
-    lv_obj_set_size(scroll_cont, LV_PCT(100), LV_PCT(100));
-    lv_obj_set_style_border_width(scroll_cont, 0, 0);
-    lv_obj_set_style_bg_opa(scroll_cont, LV_OPA_TRANSP, 0);
-    lv_obj_set_style_pad_all(scroll_cont, 0, 0);
-    lv_obj_set_flex_flow(scroll_cont, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(scroll_cont, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_scrollbar_mode(scroll_cont, LV_SCROLLBAR_MODE_AUTO);
+    LV_UNUSED(page);
+    qmc5883l_service_unregister_callback();
+    qmc5883l_service_stop();
+}
 
-    // 创建各个区域
-    create_status_section(scroll_cont);
-    create_compass_section(scroll_cont);
-    create_data_section(scroll_cont);
-    create_control_buttons(scroll_cont);
+/**
+ * 页面重新可见时恢复数据采集（服务未初始化时跳过）
+ */
+void resumePage_qmc5883l(lv_obj_t *page)
+{
+    LV_UNUSED(page);
+    if (!g_service_ready)
+        return;
+    qmc5883l_service_register_callback(qmc5883l_data_callback);
+    esp_err_t ret = qmc5883l_service_start(500);
+    if (ret != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to restart QMC5883L service: %s", esp_err_to_name(ret));
+    }
+}
 
+/**
+ * 启动QMC5883L服务和UI更新定时器（页面构建的最后一步）
+ */
+static void start_page_updates(void)
+{
     // 初始化QMC5883L服务
+    PageScope &scope = PageScope::of(g_page_screen);
     esp_err_t ret = qmc5883l_service_init();
+    g_service_ready = (ret == ESP_OK);
     if (ret == ESP_OK)
     {
-        // 注册数据回调
+        // 注册数据回调，页面删除时注销并停止采集
         qmc5883l_service_register_callback(qmc5883l_data_callback);
+        scope.addSubscription([]()
+                              {
+            qmc5883l_service_unregister_callback();
+            qmc5883l_service_stop(); });
 
         // 启动数据采集（500ms间隔，与传感器10Hz配置匹配）
         ret = qmc5883l_service_start(500);
@@ -685,7 +685,7 @@ lv_obj_t *createPage_qmc5883l(void)
     }
 
     // 创建UI更新定时器（500ms更新UI，降低更新频率）
-    g_update_timer = lv_timer_create(update_ui_timer_cb, 100, NULL);
+    g_update_timer = scope.createTimer(update_ui_timer_cb, 100, NULL);
 
     // 初始化指南针显示
     update_compass(0.0f, 0.0f);
@@ -697,9 +697,43 @@ lv_obj_t *createPage_qmc5883l(void)
         g_current_data = initial_data;
     }
 
-    // 设置页面用户数据，用于清理
-    lv_obj_set_user_data(g_page_screen, g_update_timer);
+    // 定时器和数据回调记录在页面资源作用域中，页面删除时统一释放
 
     ESP_LOGI(TAG, "QMC5883L page created successfully");
+}
+
+/**
+ * 创建QMC5883L页面
+ */
+lv_obj_t *createPage_qmc5883l(PageBuilder& builder)
+{
+    TRACE_FUNC();
+    ESP_LOGI(TAG, "Creating QMC5883L page...");
+
+    // 创建主屏幕
+    g_service_ready = false;
+    g_page_screen = lv_obj_create(NULL);
+    lv_obj_set_style_bg_color(g_page_screen, lv_color_hex(0xFAFAFA), 0);
+    lv_obj_set_style_pad_all(g_page_screen, 8, 0);
+
+    // 创建滚动容器
+    lv_obj_t *scroll_cont = lv_obj_create(g_page_screen);
+    lv_obj_set_size(scroll_cont, LV_PCT(100), LV_PCT(100));
+    lv_obj_set_style_border_width(scroll_cont, 0, 0);
+    lv_obj_set_style_bg_opa(scroll_cont, LV_OPA_TRANSP, 0);
+    lv_obj_set_style_pad_all(scroll_cont, 0, 0);
+    lv_obj_set_flex_flow(scroll_cont, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(scroll_cont, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_scrollbar_mode(scroll_cont, LV_SCROLLBAR_MODE_AUTO);
+
+    // 骨架：状态区域随页面一起创建，其余区域分帧构建
+    create_status_section(scroll_cont);
+    builder.defer([scroll_cont]() { create_compass_section(scroll_cont); });
+    builder.defer([scroll_cont]() { create_data_section(scroll_cont); });
+    builder.defer([scroll_cont]() { create_control_buttons(scroll_cont); });
+    // 所有区域创建完成后再启动服务和UI更新定时器
+    builder.defer(start_page_updates);
+
+    ESP_LOGI(TAG, "QMC5883L page skeleton created");
     return g_page_screen;
 }
@@ -0,0 +1,136 @@
+// page_scope.cpp
+// 页面资源作用域实现
+#include "page_scope.h"
+#include "system/esp_log.h"
+
+static const char *TAG = "PageScope";
+
+
+bool page_timer_alive(lv_timer_t* timer) {
+    for(lv_timer_t* t = lv_timer_get_next(NULL); t; t = lv_timer_get_next(t)) {
+        if(t == timer) return true;
+    }
+    return false;
+}
+
+
+// 页面删除时释放作用域（在子控件删除之前触发）
+void PageScope::page_delete_cb(lv_event_t* e) {
+    PageScope* scope = static_cast<PageScope*>(lv_event_get_user_data(e));
+    scope->release();
+    delete scope;
+}
+
+
+// 作用域指针保存在页面删除事件的user_data中
+PageScope* PageScope::find(lv_obj_t* page) {
+    uint32_t count = lv_obj_get_event_count(page);
+    for(uint32_t i = 0; i < count; i++) {
+        lv_event_dsc_t* dsc = lv_obj_get_event_dsc(page, i);
+        if(lv_event_dsc_get_cb(dsc) == page_delete_cb) {
+            return static_cast<PageScope*>(lv_event_dsc_get_user_data(dsc));
+        }
+    }
+    return nullptr;
+}
+
+
+PageScope& PageScope::of(lv_obj_t* page) {
+    PageScope* scope = find(page);
+    if(!scope) {
+        scope = new PageScope();
+        lv_obj_add_event_cb(page, page_delete_cb, LV_EVENT_DELETE, scope);
+    }
+    return *scope;
+}
+
+
+lv_timer_t* PageScope::createTimer(lv_timer_cb_t cb, uint32_t period, void* user_data) {
+    return addTimer(lv_timer_create(cb, period, user_data));
+}
+
+
+lv_timer_t* PageScope::addTimer(lv_timer_t* timer) {
+    if(timer) {
+        timers.push_back(timer);
+        if(paused) lv_timer_pause(timer);
+    }
+    return timer;
+}
+
+
+void PageScope::deleteTimer(lv_timer_t* timer) {
+    for(auto it = timers.begin(); it != timers.end(); ++it) {
+        if(*it == timer) {
+            timers.erase(it);
+            lv_timer_del(timer);
+            return;
+        }
+    }
+}
+
+
+void PageScope::addEventCb(lv_obj_t* obj, lv_event_cb_t cb, lv_event_code_t filter, void* user_data) {
+    lv_obj_add_event_cb(obj, cb, filter, user_data);
+    events.push_back({obj, cb, user_data});
+}
+
+
+void PageScope::addSubscription(std::function<void()> unsubscribe) {
+    subscriptions.push_back({nullptr, std::move(unsubscribe)});
+}
+
+
+void PageScope::addSubscription(std::function<void()> subscribe, std::function<void()> unsubscribe) {
+    if(!paused) subscribe();
+    subscriptions.push_back({std::move(subscribe), std::move(unsubscribe)});
+}
+
+
+// 页面不可见：暂停定时器，按注册的逆序注销可暂停的订阅
+void PageScope::pause() {
+    if(paused) return;
+    paused = true;
+    for(lv_timer_t* t : timers) {
+        if(page_timer_alive(t)) lv_timer_pause(t);
+    }
+    for(auto it = subscriptions.rbegin(); it != subscriptions.rend(); ++it) {
+        if(it->subscribe) it->unsubscribe();
+    }
+}
+
+
+void PageScope::resume() {
+    if(!paused) return;
+    paused = false;
+    for(const auto& sub : subscriptions) {
+        if(sub.subscribe) sub.subscribe();
+    }
+    for(lv_timer_t* t : timers) {
+        if(page_timer_alive(t)) lv_timer_resume(t);
+    }
+}
+
+
+// 先注销订阅，避免服务回调在释放过程中访问页面数据；暂停时已注销的订阅不再重复注销
+void PageScope::release() {
+    for(auto it = subscriptions.rbegin(); it != subscriptions.rend(); ++it) {
+        if(!it->subscribe || !paused) it->unsubscribe();
+    }
+    for(const auto& ev : events) {
+        if(lv_obj_is_valid(ev.obj)) lv_obj_remove_event_cb_with_user_data(ev.obj, ev.cb, ev.user_data);
+    }
+    size_t deleted = 0;
+    for(lv_timer_t* t : timers) {
+        if(page_timer_alive(t)) {
+            lv_timer_del(t);
+            deleted++;
+        }
+    }
+    ESP_LOGD(TAG, "Released %u subscriptions, %u event callbacks, %u timers",
+             (unsigned)subscriptions.size(), (unsigned)events.size(), (unsigned)deleted);
+
+    subscriptions.clear();
+    events.clear();
+    timers.clear();
+}
@@ -0,0 +1,63 @@
+// page_scope.h
+// 页面资源作用域：记录页面创建的定时器、事件回调和服务订阅，页面不可见时暂停，页面删除时统一释放
+#pragma once
+#include "lvgl/lvgl.h"
+#include <vector>
+#include <functional>
+
+
+class PageScope {
+public:
+    // 获取页面的资源作用域，不存在时创建；作用域在页面收到LV_EVENT_DELETE时释放并销毁
+    static PageScope& of(lv_obj_t* page);
+    // 查找页面的资源作用域，未创建时返回nullptr
+    static PageScope* find(lv_obj_t* page);
+
+    // 创建并记录定时器；页面暂停期间创建的定时器同样暂停
+    lv_timer_t* createTimer(lv_timer_cb_t cb, uint32_t period, void* user_data);
+    // 记录已创建的定时器
+    lv_timer_t* addTimer(lv_timer_t* timer);
+    // 提前删除定时器并停止记录；一次性定时器应在回调中通过此函数删除，避免记录失效指针
+    void deleteTimer(lv_timer_t* timer);
+
+    // 添加并记录事件回调，用于页面外的对象（如lv_layer_top上的控件）
+    void addEventCb(lv_obj_t* obj, lv_event_cb_t cb, lv_event_code_t filter, void* user_data);
+
+    // 记录服务订阅的注销函数，释放时按注册的逆序调用
+    void addSubscription(std::function<void()> unsubscribe);
+    // 记录可暂停的服务订阅：作用域未暂停时立即调用subscribe；暂停时调用unsubscribe，
+    // 恢复时重新调用subscribe，释放时若仍处于订阅状态则调用unsubscribe
+    void addSubscription(std::function<void()> subscribe, std::function<void()> unsubscribe);
+
+    // 暂停/恢复记录的定时器和可暂停的订阅（页面不可见时由PageManager调用）
+    void pause();
+    void resume();
+    bool isPaused() const { return paused; }
+
+    // 释放全部资源：注销订阅、移除事件回调、删除定时器
+    void release();
+
+    size_t timerCount() const { return timers.size(); }
+
+private:
+    struct EventBinding {
+        lv_obj_t* obj;
+        lv_event_cb_t cb;
+        void* user_data;
+    };
+    struct Subscription {
+        std::function<void()> subscribe;    // 为空时只在释放时注销
+        std::function<void()> unsubscribe;
+    };
+
+    static void page_delete_cb(lv_event_t* e);
+
+    std::vector<lv_timer_t*> timers;
+    std::vector<EventBinding> events;
+    std::vector<Subscription> subscriptions;
+    bool paused = false;
+};
+
+
+// 定时器是否仍存在（定时器可能已被删除）
+bool page_timer_alive(lv_timer_t* timer);
@@ -2,6 +2,8 @@
 #include "page_manager.h"
 #include "pages_common.h"
 #include "system/filesystem_service.hpp"
+#include "system/dir_loader.hpp"
+#include "page_scope.h"
 #include "system/sd_init_windows.h"
 #include "system/esp_log.h"
 #include "system/esp_err_to_name.h"
@@ -25,9 +27,31 @@ static char current_path[MAX_PATH_LEN] = "C:\\Users";
 #else
 static char current_path[MAX_PATH_LEN] = "/:";
 #endif
-static file_info_t *current_files = nullptr;
-static int current_file_count = 0;
-static bool is_loading = false;  // 加载状态标识
+static fs_dir_list_t current_list = {};   // 当前目录（不含隐藏文件），排序后的位置即条目号
+static bool has_back_row = false;         // 第0行是否为"Back to parent"
+static bool is_loading = false;  // 后台正在加载当前目录
+static int32_t pending_scroll_y = 0;   // 恢复页面时加载完成后要滚动到的位置
+
+// 列表读取方式，也是目录缓存的键的一部分
+#define LIST_SORT       SORT_BY_NAME_ASC
+#define LIST_FLAGS      (FS_LIST_SIZE | FS_LIST_SKIP_HIDDEN)
+
+// 虚拟列表：只创建视口可见的行加上下各ROW_OVERSCAN行，滚动时把移出视口的行重新绑定到新进入的行号。
+// 行号row对应固定的槽位row % row_pool_count，仍然可见的行不需要重新绑定。
+#define ROW_OVERSCAN    2
+#define ROW_POOL_MAX    32
+
+static lv_obj_t *row_pool[ROW_POOL_MAX];
+static int32_t row_pool_row[ROW_POOL_MAX];     // 槽位当前显示的行号，-1为未绑定
+static uint32_t row_pool_count = 0;
+static int32_t row_height = 0;
+static lv_obj_t *list_spacer = nullptr;        // 高度为所有行的总高度，撑开滚动范围
+static lv_obj_t *list_msg_label = nullptr;     // 错误/提示信息
+
+// 所有行共用的样式，按状态切换而不是每行设置本地样式
+static lv_style_t style_dir_row;       // LV_STATE_USER_1：目录
+static lv_style_t style_back_row;      // LV_STATE_USER_2：返回上级
+static bool row_styles_inited = false;
 
 // 图标定义 (使用LVGL内置符号)
 #define ICON_FOLDER     LV_SYMBOL_DIRECTORY
@@ -37,10 +61,10 @@ static bool is_loading = false;  // 加载状态标识
 #define ICON_UP         LV_SYMBOL_UP
 
 // 格式化文件大小
-static void format_file_size(size_t size, char *buffer, size_t buffer_size)
+static void format_file_size(uint64_t size, char *buffer, size_t buffer_size)
 {
     if (size < 1024) {
-        snprintf(buffer, buffer_size, "%zu B", size);
+        snprintf(buffer, buffer_size, "%u B", (unsigned)size);
     } else if (size < 1024 * 1024) {
         snprintf(buffer, buffer_size, "%.1f KB", size / 1024.0);
     } else if (size < 1024 * 1024 * 1024) {
@@ -94,60 +118,246 @@ static void update_status_label()
         format_file_size(storage_info.total_bytes, size_str, sizeof(size_str));
         format_file_size(storage_info.free_bytes, free_str, sizeof(free_str));
 
-        lv_label_set_text_fmt(status_label, "%s/%s | %d",
-                              free_str, size_str,  current_file_count);
+        lv_label_set_text_fmt(status_label, "%s/%s | %u",
+                              free_str, size_str, (unsigned)current_list.count);
     } else {
-        lv_label_set_text_fmt(status_label, "Files: %d", current_file_count);
+        lv_label_set_text_fmt(status_label, "Files: %u", (unsigned)current_list.count);
     }
 }
 
 // 清理文件列表数据
 static void cleanup_file_data()
 {
-    if (current_files) {
-        fs_free_file_list(current_files, current_file_count);
-        current_files = nullptr;
-        current_file_count = 0;
+    fs_dir_list_free(&current_list);
+}
+
+static uint32_t total_rows()
+{
+    return (has_back_row ? 1 : 0) + current_list.count;
+}
+
+// 把槽位绑定到行号，行号未变时不做任何事
+static void bind_row(uint32_t slot, int32_t row)
+{
+    if (row_pool_row[slot] == row) return;
+    row_pool_row[slot] = row;
+
+    lv_obj_t *item = row_pool[slot];
+    lv_obj_t *icon = lv_obj_get_child(item, 0);
+    lv_obj_t *label = lv_obj_get_child(item, 1);
+    lv_obj_set_y(item, row * row_height);
+    lv_obj_remove_state(item, LV_STATE_USER_1 | LV_STATE_USER_2);
+
+    if (has_back_row && row == 0) {
+        lv_image_set_src(icon, ICON_UP);
+        lv_label_set_text(label, "Back to parent");
+        lv_obj_add_state(item, LV_STATE_USER_2);
+        // 设置特殊用户数据标识返回按钮
+        lv_obj_set_user_data(item, (void*)(-1));
+        return;
+    }
+
+    uint32_t index = row - (has_back_row ? 1 : 0);
+    const char *name = fs_dir_list_name(&current_list, index);
+    file_type_t type = fs_dir_list_type(&current_list, index);
+    lv_image_set_src(icon, get_file_icon(type, name));
+    if (type == FILE_TYPE_DIRECTORY) {
+        lv_label_set_text(label, name);
+        lv_obj_add_state(item, LV_STATE_USER_1);
+    } else {
+        char size_str[32];
+        format_file_size(fs_dir_list_size(&current_list, index), size_str, sizeof(size_str));
+        lv_label_set_text_fmt(label, "%s (%s)", name, size_str);
+    }
+    // 存储条目号到用户数据
+    lv_obj_set_user_data(item, (void*)(intptr_t)index);
+}
+
+// 按滚动位置绑定可见行，超出行数的槽位隐藏
+static void update_visible_rows()
+{
+    if (!file_list || row_height <= 0) return;
+
+    int32_t total = (int32_t)total_rows();
+    int32_t first = lv_obj_get_scroll_y(file_list) / row_height - ROW_OVERSCAN;
+    if (first < 0) first = 0;
+
+    for (int32_t row = first; row < first + (int32_t)row_pool_count; row++) {
+        uint32_t slot = row % row_pool_count;
+        if (row < total) {
+            bind_row(slot, row);
+            lv_obj_remove_flag(row_pool[slot], LV_OBJ_FLAG_HIDDEN);
+        } else {
+            row_pool_row[slot] = -1;
+            lv_obj_add_flag(row_pool[slot], LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+static void file_list_scroll_cb(lv_event_t *e)
+{
+    LV_UNUSED(e);
+    update_visible_rows();
+}
+
+// 行数或顺序变化后重设滚动范围，按当前滚动位置重新绑定
+static void rebind_rows()
+{
+    for (uint32_t i = 0; i < row_pool_count; i++) {
+        row_pool_row[i] = -1;
+    }
+    lv_obj_set_height(list_spacer, (int32_t)total_rows() * row_height);
+    update_visible_rows();
+}
+
+// 回到顶部重新绑定；msg不为NULL时在行下方显示提示
+static void reset_rows(const char *msg)
+{
+    int32_t content_h = (int32_t)total_rows() * row_height;
+    if (msg) {
+        lv_label_set_text(list_msg_label, msg);
+        lv_obj_align(list_msg_label, LV_ALIGN_TOP_MID, 0, content_h + 10);
+        lv_obj_remove_flag(list_msg_label, LV_OBJ_FLAG_HIDDEN);
+    } else {
+        lv_obj_add_flag(list_msg_label, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    lv_obj_scroll_to_y(file_list, 0, LV_ANIM_OFF);
+    rebind_rows();
+}
+
+// 创建行池：先创建一行量出行高，再按显示高度决定行数
+static void create_row_pool()
+{
+    if (!row_styles_inited) {
+        lv_style_init(&style_dir_row);
+        lv_style_set_text_color(&style_dir_row, lv_color_hex(0x4CAF50));
+        lv_style_init(&style_back_row);
+        lv_style_set_bg_color(&style_back_row, lv_color_hex(0x2196F3));
+        lv_style_set_text_color(&style_back_row, lv_color_white());
+        row_styles_inited = true;
+    }
+
+    // 行的位置由update_visible_rows设置，不使用列表的flex布局
+    lv_obj_set_layout(file_list, LV_LAYOUT_NONE);
+    lv_obj_add_event_cb(file_list, file_list_scroll_cb, LV_EVENT_SCROLL, NULL);
+
+    list_spacer = lv_obj_create(file_list);
+    lv_obj_remove_style_all(list_spacer);
+    lv_obj_remove_flag(list_spacer, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_set_size(list_spacer, 1, 0);
+
+    list_msg_label = lv_label_create(file_list);
+    lv_obj_set_width(list_msg_label, LV_PCT(100));
+    lv_obj_set_style_text_align(list_msg_label, LV_TEXT_ALIGN_CENTER, 0);
+    lv_label_set_long_mode(list_msg_label, LV_LABEL_LONG_WRAP);
+    lv_obj_add_flag(list_msg_label, LV_OBJ_FLAG_HIDDEN);
+
+    row_pool_count = 0;
+    row_height = 0;
+    int32_t view_h = lv_display_get_vertical_resolution(lv_obj_get_display(file_list));
+    uint32_t want = 1;
+    while (row_pool_count < want) {
+        lv_obj_t *item = lv_list_add_btn(file_list, ICON_FILE, "");
+        lv_obj_set_width(item, LV_PCT(100));
+        lv_obj_add_style(item, &style_dir_row, LV_STATE_USER_1);
+        lv_obj_add_style(item, &style_back_row, LV_STATE_USER_2);
+        lv_label_set_long_mode(lv_obj_get_child(item, 1), LV_LABEL_LONG_DOT);
+        lv_obj_add_event_cb(item, file_list_event_cb, LV_EVENT_CLICKED, NULL);
+
+        if (row_height == 0) {
+            lv_obj_update_layout(item);
+            row_height = LV_MAX(lv_obj_get_height(item), 1);
+            want = LV_MIN(ROW_POOL_MAX, view_h / row_height + 2 + 2 * ROW_OVERSCAN);
+        }
+        lv_obj_set_height(item, row_height);
+        lv_obj_add_flag(item, LV_OBJ_FLAG_HIDDEN);
+        row_pool[row_pool_count] = item;
+        row_pool_row[row_pool_count] = -1;
+        row_pool_count++;
+    }
+    ESP_LOGI(TAG, "File list rows: %u x %d px", (unsigned)row_pool_count, (int)row_height);
+}
+
+// 后台加载的一批目录项（UI线程）：归并进当前列表，可见行立即更新
+static void file_list_batch_cb(const fs_dir_list_t *batch, bool done, esp_err_t status, bool from_cache)
+{
+    // 页面已删除：取消前已排队的批次不能再访问控件
+    if (!file_list) return;
+
+    if (fs_dir_list_merge(&current_list, batch, LIST_SORT) != ESP_OK && status == ESP_OK) {
+        status = ESP_ERR_NO_MEM;
+    }
+    if (!done && status != ESP_OK) {
+        DirLoader::instance().cancel();
+        done = true;
+    }
+
+    if (!done) {
+        rebind_rows();
+        if (status_label) {
+            lv_label_set_text_fmt(status_label, "Loading... %u", (unsigned)current_list.count);
+        }
+        return;
+    }
+
+    is_loading = false;  // 清除加载状态
+    if (status != ESP_OK) {
+        char msg[64];
+        snprintf(msg, sizeof(msg), "Cannot read directory: %s", esp_err_to_name(status));
+        reset_rows(msg);
+    } else {
+        rebind_rows();
+        // 从SD卡读出的完整列表存入目录缓存，返回上级和再次进入时不必重新读取
+        if (!from_cache) {
+            fs_dir_cache_store(current_path, &current_list, LIST_SORT, LIST_FLAGS);
+        }
     }
+
+    // 页面恢复时等列表完整后再滚动到保存的位置
+    if (pending_scroll_y > 0) {
+        lv_obj_update_layout(file_list);
+        lv_obj_scroll_to_y(file_list, pending_scroll_y, LV_ANIM_OFF);
+        pending_scroll_y = 0;
+    }
+
+    // 更新状态标签
+    update_status_label();
+
+    ESP_LOGI(TAG, "File list refreshed: %u items in %s (%u KB)", (unsigned)current_list.count, current_path,
+             (unsigned)(fs_dir_list_memory(&current_list) / 1024));
 }
 
-// 刷新文件列表
+// 刷新文件列表：目录在后台线程分批读取，这里只重置列表并开始加载；正在进行的加载被取消
 static void refresh_file_list()
 {
-    if (!file_list || is_loading) return;  // 如果正在加载则返回
+    TRACE_FUNC();
+    if (!file_list) return;
 
-    is_loading = true;  // 设置加载状态
+    DirLoader::instance().cancel();
+    is_loading = false;
 
     // 显示加载提示
     if (status_label) {
         lv_label_set_text(status_label, "Loading...");
     }
 
-    // 清除现有项目
-    lv_obj_clean(file_list);
     cleanup_file_data();
+    has_back_row = false;
 
     // 检查文件系统是否可用
     if (!filesystem_service_is_available()) {
-        lv_obj_t *no_fs_label = lv_label_create(file_list);
-        lv_label_set_text(no_fs_label, "Filesystem not available");
-		lv_obj_set_style_text_font(no_fs_label, &NotoSansSC_Medium_3500, 0);
-        lv_obj_set_style_text_align(no_fs_label, LV_TEXT_ALIGN_CENTER, 0);
-        lv_obj_center(no_fs_label);
+        reset_rows("Filesystem not available");
         update_status_label();
-        is_loading = false;  // 清除加载状态
         return;
     }
 
     // 检查当前路径是否存在
     if (!fs_is_path_exists(current_path)) {
-        lv_obj_t *no_path_label = lv_label_create(file_list);
-        lv_label_set_text_fmt(no_path_label, "Path not found: %s", current_path);
-		lv_obj_set_style_text_font(no_path_label, &NotoSansSC_Medium_3500, 0);
-        lv_obj_set_style_text_align(no_path_label, LV_TEXT_ALIGN_CENTER, 0);
-        lv_obj_center(no_path_label);
+        char msg[MAX_PATH_LEN + 32];
+        snprintf(msg, sizeof(msg), "Path not found: %s", current_path);
+        reset_rows(msg);
         update_status_label();
-        is_loading = false;  // 清除加载状态
         return;
     }
 
@@ -157,76 +367,17 @@ static void refresh_file_list()
 #else
     bool is_root = (strcmp(current_path, "/") == 0);
 #endif
-    if (!is_root) {
-        lv_obj_t *back_item = lv_list_add_btn(file_list, ICON_UP, "Back to parent");
-        lv_obj_set_style_bg_color(back_item, lv_color_hex(0x2196F3), 0);
-        lv_obj_set_style_text_color(back_item, lv_color_white(), 0);
-		lv_obj_set_style_text_font(back_item, &NotoSansSC_Medium_3500, 0);
-        // 设置特殊用户数据标识返回按钮
-        lv_obj_set_user_data(back_item, (void*)(-1));
-        // 为返回按钮添加点击事件处理
-        lv_obj_add_event_cb(back_item, file_list_event_cb, LV_EVENT_CLICKED, NULL);
-    }
-
-    // 获取文件列表
-    esp_err_t ret = fs_list_directory(current_path, &current_files, &current_file_count, SORT_BY_NAME_ASC);
-    if (ret != ESP_OK) {
-        lv_obj_t *error_label = lv_label_create(file_list);
-        lv_label_set_text_fmt(error_label, "Cannot read directory: %s", esp_err_to_name(ret));
-		lv_obj_set_style_text_font(error_label, &NotoSansSC_Medium_3500, 0);
-        lv_obj_set_style_text_align(error_label, LV_TEXT_ALIGN_CENTER, 0);
-        lv_obj_center(error_label);
-        update_status_label();
-        is_loading = false;  // 清除加载状态
-        return;
-    }
-
-    // 添加文件和目录到列表
-    for (int i = 0; i < current_file_count; i++) {
-        file_info_t *file = &current_files[i];
-
-        // 跳过隐藏文件（可选）
-        if (file->is_hidden) {
-            continue;
-        }
-
-        const char *icon = get_file_icon(file->type, file->name);
-
-        // 创建文件项
-        char item_text[512];
-        if (file->type == FILE_TYPE_DIRECTORY) {
-            snprintf(item_text, sizeof(item_text), "%s", file->name);
-        } else {
-            char size_str[32];
-            format_file_size(file->size, size_str, sizeof(size_str));
-            snprintf(item_text, sizeof(item_text), "%s (%s)", file->name, size_str);
-        }
-
-        lv_obj_t *item = lv_list_add_btn(file_list, icon, item_text);
-
-        // 为目录和文件设置不同的颜色
-        if (file->type == FILE_TYPE_DIRECTORY) {
-            lv_obj_set_style_text_color(item, lv_color_hex(0x4CAF50), 0);
-        }
-
-        // 存储文件索引到用户数据
-        lv_obj_set_user_data(item, (void*)(intptr_t)i);
-
-        // 为每个列表项添加点击事件处理
-        lv_obj_add_event_cb(item, file_list_event_cb, LV_EVENT_CLICKED, NULL);
-    }
+    has_back_row = !is_root;
+    reset_rows(nullptr);
 
     // 更新路径标签
     if (path_label) {
         lv_label_set_text(path_label, current_path);
     }
 
-    // 更新状态标签
-    update_status_label();
-
-    is_loading = false;  // 清除加载状态
-
-    ESP_LOGI(TAG, "File list refreshed: %d items in %s", current_file_count, current_path);
+    // 获取文件列表（跳过隐藏文件，列表中的位置直接对应行号）
+    is_loading = true;  // 设置加载状态
+    DirLoader::instance().start(current_path, LIST_SORT, LIST_FLAGS, file_list_batch_cb);
 }
 
 // 文件列表点击事件处理
@@ -236,12 +387,7 @@ static void file_list_event_cb(lv_event_t *e)
     lv_obj_t *btn = (lv_obj_t*)lv_event_get_target(e);
 
     if (code == LV_EVENT_CLICKED) {
-        // 防止重复点击
-        if (is_loading) {
-            ESP_LOGW(TAG, "Already loading, ignoring click");
-            return;
-        }
-
+        // 加载中也可以点击：已显示的项有效，进入其他目录会取消当前加载
         // 获取用户数据
         intptr_t file_index = (intptr_t)lv_obj_get_user_data(btn);
         ESP_LOGI(TAG, "Button clicked, file_index: %d", (int)file_index);
@@ -263,21 +409,25 @@ static void file_list_event_cb(lv_event_t *e)
         }
 
         // 处理文件/目录点击
-        if (file_index >= 0 && file_index < current_file_count) {
-            file_info_t *selected_file = &current_files[file_index];
+        if (file_index >= 0 && file_index < (intptr_t)current_list.count) {
+            uint32_t index = (uint32_t)file_index;
+            const char *name = fs_dir_list_name(&current_list, index);
+            file_type_t type = fs_dir_list_type(&current_list, index);
+            char full_path[MAX_PATH_LEN];
+            fs_dir_list_full_path(&current_list, index, full_path, sizeof(full_path));
 
-            ESP_LOGI(TAG, "File clicked: %s, type: %d", selected_file->name, selected_file->type);
+            ESP_LOGI(TAG, "File clicked: %s, type: %d", name, type);
 
-            if (selected_file->type == FILE_TYPE_DIRECTORY) {
+            if (type == FILE_TYPE_DIRECTORY) {
                 // 进入目录
-                strncpy(current_path, selected_file->full_path, sizeof(current_path) - 1);
+                strncpy(current_path, full_path, sizeof(current_path) - 1);
                 current_path[sizeof(current_path) - 1] = '\0';
                 ESP_LOGI(TAG, "Entering directory: %s", current_path);
                 refresh_file_list();
             } else {
+                uint64_t size = fs_dir_list_size(&current_list, index);
                 // 选中文件，显示信息（可以扩展为打开文件）
-                ESP_LOGI(TAG, "Selected file: %s (%zu bytes)",
-                        selected_file->name, selected_file->size);
+                ESP_LOGI(TAG, "Selected file: %s (%llu bytes)", name, (unsigned long long)size);
 
                 // 创建文件信息对话框
                 lv_obj_t *mbox = lv_msgbox_create(NULL);
@@ -288,12 +438,12 @@ static void file_list_event_cb(lv_event_t *e)
                 // 格式化文件信息
                 char file_info[512];
                 char size_str[32];
-                format_file_size(selected_file->size, size_str, sizeof(size_str));
+                format_file_size(size, size_str, sizeof(size_str));
 
                 int written = snprintf(file_info, sizeof(file_info),
                     "Name: %s\nPath: %s\nSize: %s",
-                    selected_file->name,
-                    selected_file->full_path,
+                    name,
+                    full_path,
                     size_str);
                 if (written < 0 || written >= (int)sizeof(file_info)) {
                     // Truncated, show warning
@@ -319,10 +469,10 @@ static void refresh_btn_event_cb(lv_event_t *e)
 {
     lv_event_code_t code = lv_event_get_code(e);
     if (code == LV_EVENT_CLICKED) {
-        if (!is_loading) {  // 防止重复点击
-            ESP_LOGI(TAG, "Refresh button clicked");
-            refresh_file_list();
-        }
+        // 加载中点击会取消并重新开始加载；FAT上目录的修改时间不可靠，刷新时不使用缓存
+        ESP_LOGI(TAG, "Refresh button clicked");
+        fs_dir_cache_invalidate(current_path);
+        refresh_file_list();
     }
 }
 
@@ -331,15 +481,62 @@ static void back_btn_event_cb(lv_event_t *e)
 {
     lv_event_code_t code = lv_event_get_code(e);
     if (code == LV_EVENT_CLICKED) {
-        cleanup_file_data();
+        // 页面可能被页面管理器缓存，列表项仍引用current_list，数据在下次刷新时释放
         g_pageManager.back();
     }
 }
 
+// 内存紧张页面被销毁前保存当前路径和列表滚动位置
+void savePage_sd_files(lv_obj_t *page, PageState &state)
+{
+    LV_UNUSED(page);
+    state.path = current_path;
+    state.scroll_y = file_list ? lv_obj_get_scroll_y(file_list) : 0;
+}
+
+// 页面重建后恢复路径和滚动位置
+void restorePage_sd_files(lv_obj_t *page, const PageState &state)
+{
+    LV_UNUSED(page);
+    if (!state.path.empty() && state.path != current_path) {
+        strncpy(current_path, state.path.c_str(), sizeof(current_path) - 1);
+        current_path[sizeof(current_path) - 1] = '\0';
+        refresh_file_list();
+    }
+    // 列表还在加载时由file_list_batch_cb在加载完成后滚动
+    if (is_loading) {
+        pending_scroll_y = state.scroll_y;
+    } else if (file_list) {
+        lv_obj_update_layout(file_list);
+        lv_obj_scroll_to_y(file_list, state.scroll_y, LV_ANIM_OFF);
+    }
+}
+
+// 页面删除时重置控件指针（定时器和后台加载由页面资源作用域释放）
+static void sd_page_delete_cb(lv_event_t *e)
+{
+    // 同名新页面可能在旧页面删除前创建，静态变量已属于新页面时不重置
+    if (lv_event_get_target(e) != sd_page) return;
+
+    sd_page = nullptr;
+    file_list = nullptr;
+    path_label = nullptr;
+    status_label = nullptr;
+    back_btn = nullptr;
+    refresh_btn = nullptr;
+    list_spacer = nullptr;
+    list_msg_label = nullptr;
+    memset(row_pool, 0, sizeof(row_pool));
+    row_pool_count = 0;
+    row_height = 0;
+}
+
 lv_obj_t* createPage_sd_files()
 {
+    TRACE_FUNC();
     // 创建主页面
     sd_page = lv_obj_create(NULL);
+    lv_obj_add_event_cb(sd_page, sd_page_delete_cb, LV_EVENT_DELETE, NULL);
     lv_obj_set_style_bg_color(sd_page, lv_color_hex(0x000000), 0);
     lv_obj_set_style_pad_all(sd_page, 0, 0);  // 去除边距
     lv_obj_set_flex_flow(sd_page, LV_FLEX_FLOW_COLUMN);  // 弹性布局
@@ -400,6 +597,7 @@ lv_obj_t* createPage_sd_files()
     lv_obj_set_style_bg_color(file_list, lv_color_hex(0x111111), 0);
     lv_obj_set_style_pad_all(file_list, 0, 0);  // 去除边距
     lv_obj_set_style_text_font(file_list, &NotoSansSC_Medium_3500, 0);  // 使用中文字体
+    create_row_pool();
 
     // 创建状态栏
     status_label = lv_label_create(sd_page);
@@ -419,6 +617,13 @@ lv_obj_t* createPage_sd_files()
         ESP_LOGW(TAG, "Filesystem service initialization failed");
     }
 
+    // 页面删除时取消后台加载，批次回调不能再访问已删除的控件
+    PageScope::of(sd_page).addSubscription([]() {
+        DirLoader::instance().cancel();
+        is_loading = false;
+        pending_scroll_y = 0;
+    });
+
     // 刷新文件列表
     refresh_file_list();
 
@@ -545,8 +545,9 @@ void Version_msgbox(lv_event_t *e)
     lv_label_set_long_mode(label4, LV_LABEL_LONG_WRAP);
     lv_obj_set_width(label4, lv_pct(100));
 }
-lv_obj_t *createPage_settings(void)
+lv_obj_t *createPage_settings(PageBuilder &builder)
 {
+    TRACE_FUNC();
 
     lv_obj_t *setting_page = lv_obj_create(NULL);
     lv_obj_t *status = lv_obj_create(setting_page);
@@ -571,38 +572,49 @@ lv_obj_t *createPage_settings(void)
     settings_list = lv_list_create(status);
     lv_obj_set_size(settings_list, LV_HOR_RES, LV_SIZE_CONTENT);
     lv_obj_center(settings_list);
-    lv_obj_t *btn;
-    lv_list_add_text(settings_list, "Connectivity");
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_WIFI, "WLAN");
-    lv_obj_add_event_cb(btn, WiFi_msgbox, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_BLUETOOTH, "Bluetooth");
-    lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_GPS, "Navigation");
-    lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_USB, "USB");
-    lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_BATTERY_FULL, "Battery");
-    lv_obj_add_event_cb(btn, Battery_msgbox, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_SD_CARD, "SD Card");
-    lv_obj_add_event_cb(btn, SDCard_msgbox, LV_EVENT_CLICKED, NULL);
-
-    lv_list_add_text(settings_list, "System");
-    btn = lv_list_add_button(settings_list, MY_SYMBOL_PHONE, "Brightness");
-    lv_obj_add_event_cb(btn, Brightness_msgbox, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_VOLUME_MID, "Volume");
-    lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, MY_SYMBOL_TIME, "Time");
-    lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, MY_SYMBOL_BELL, "Alarm");
-    lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
-
-    lv_list_add_text(settings_list, "About");
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_HOME, "Version");
-    lv_obj_add_event_cb(btn, Version_msgbox, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_LIST, "Status");
-    lv_obj_add_event_cb(btn, Status_msgbox, LV_EVENT_CLICKED, NULL);
-    btn = lv_list_add_button(settings_list, LV_SYMBOL_DOWNLOAD, "OTA Update");
-    lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+
+    // 骨架：返回按钮和空列表，各分组分帧添加
+    lv_obj_t *list = settings_list;
+    builder.defer([list]() {
+        lv_obj_t *btn;
+        lv_list_add_text(list, "Connectivity");
+        btn = lv_list_add_button(list, LV_SYMBOL_WIFI, "WLAN");
+        lv_obj_add_event_cb(btn, WiFi_msgbox, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_BLUETOOTH, "Bluetooth");
+        lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_GPS, "Navigation");
+        lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_USB, "USB");
+        lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_BATTERY_FULL, "Battery");
+        lv_obj_add_event_cb(btn, Battery_msgbox, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_SD_CARD, "SD Card");
+        lv_obj_add_event_cb(btn, SDCard_msgbox, LV_EVENT_CLICKED, NULL);
+    });
+
+    builder.defer([list]() {
+        lv_obj_t *btn;
+        lv_list_add_text(list, "System");
+        btn = lv_list_add_button(list, MY_SYMBOL_PHONE, "Brightness");
+        lv_obj_add_event_cb(btn, Brightness_msgbox, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_VOLUME_MID, "Volume");
+        lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, MY_SYMBOL_TIME, "Time");
+        lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, MY_SYMBOL_BELL, "Alarm");
+        lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+    });
+
+    builder.defer([list]() {
+        lv_obj_t *btn;
+        lv_list_add_text(list, "About");
+        btn = lv_list_add_button(list, LV_SYMBOL_HOME, "Version");
+        lv_obj_add_event_cb(btn, Version_msgbox, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_LIST, "Status");
+        lv_obj_add_event_cb(btn, Status_msgbox, LV_EVENT_CLICKED, NULL);
+        btn = lv_list_add_button(list, LV_SYMBOL_DOWNLOAD, "OTA Update");
+        lv_obj_add_event_cb(btn, event_handler, LV_EVENT_CLICKED, NULL);
+    });
 
     return setting_page;
 }
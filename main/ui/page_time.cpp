@@ -1,6 +1,8 @@
 #include "lvgl/lvgl.h"
 #include "page_manager.h"
+#include "page_scope.h"
 #include "pages_common.h"
+#include "label_bind.h"
 #include "system/time_service.h"
 #include "system/battery_service.h"
 #include "system/wifi_manager.h"
@@ -15,7 +17,6 @@ lv_obj_t *label_second;
 lv_obj_t *label_running;
 lv_obj_t *label_BATTERY;
 lv_obj_t *label_weather;
-static lv_timer_t *ui_update_timer = NULL;
 static battery_service::BatteryInfo g_battery_info = {};
 
 void time_page_cb(lv_event_t *event){
@@ -29,23 +30,24 @@ static void lvgl_time_update_cb(lv_timer_t *timer)
         // 获取最新时间信息
         time_service::TimeInfo info = time_service::get_time_info();
 
+        // 内容不变时不重绘（见label_bind.h）：HH:MM每分钟才变化一次
         // 更新主时间显示 (HH:MM)
-        lv_label_set_text_fmt(label_time, "#ffffff %s#", info.time_str);
+        label_bind_set_text_fmt(label_time, "#ffffff %s#", info.time_str);
 
         // 更新电池信息显示
         if (g_battery_info.is_valid) {
             const char* charging_icon = g_battery_info.is_charging ? LV_SYMBOL_CHARGE : "";
-            lv_label_set_text_fmt(label_BATTERY, "Battery: %d%% %s",
-                                  g_battery_info.percentage, charging_icon);
+            label_bind_values(label_BATTERY, 1.0f, "Battery: %d%% %s",
+                              g_battery_info.percentage, charging_icon);
         } else {
-            lv_label_set_text(label_BATTERY, "Battery: N/A");
+            label_bind_set_text(label_BATTERY, "Battery: N/A");
         }
 
         // 更新详细时间显示 (YYYY-MM-DD HH:MM:SS)
-        lv_label_set_text_fmt(label_second, "#ffffff %s#", info.datetime_str);
+        label_bind_set_text_fmt(label_second, "#ffffff %s#", info.datetime_str);
 
         // 更新运行时间
-        lv_label_set_text(label_running, info.running_str);
+        label_bind_set_text(label_running, info.running_str);
     }
 }
 
@@ -65,26 +67,9 @@ static void time_update_callback(const time_service::TimeInfo& info)
     // UI更新由LVGL定时器处理，避免在定时器上下文中操作UI
 }
 
-// 页面删除事件回调
-static void time_page_delete_cb(lv_event_t *e)
-{
-    // 移除时间更新回调
-    time_service::remove_time_update_callback();
-
-    // 移除电池更新回调
-    battery_service::remove_battery_update_callback();
-
-    // 删除LVGL定时器
-    if (ui_update_timer) {
-        lv_timer_del(ui_update_timer);
-        ui_update_timer = NULL;
-    }
-
-    ESP_LOGI(TAG, "Time page cleanup completed");
-}
-
 lv_obj_t *createPage_time()
 {
+    TRACE_FUNC();
     // 检查 WiFi 连接状态
     if (!wifi_manager_is_connected())
     {
@@ -96,7 +81,6 @@ lv_obj_t *createPage_time()
 
     lv_obj_t *time_page = lv_obj_create(NULL);
     lv_obj_add_event_cb(time_page, time_page_cb, LV_EVENT_PRESSED, NULL);
-    lv_obj_add_event_cb(time_page, time_page_delete_cb, LV_EVENT_DELETE, NULL);
     lv_obj_set_style_bg_color(time_page, lv_color_black(), 0);
 
     label_time = lv_label_create(time_page);
@@ -127,22 +111,24 @@ lv_obj_t *createPage_time()
     lv_obj_align(label_weather, LV_ALIGN_TOP_LEFT, 0, 0);
 
     // 创建LVGL定时器用于UI更新（在LVGL任务中执行，避免看门狗超时）
-    ui_update_timer = lv_timer_create(lvgl_time_update_cb, 1000, NULL);
-
-    // 注册系统时间回调用于其他逻辑
-    time_service::set_time_update_callback(time_update_callback);
-
-    // 注册电池状态回调
-    battery_service::set_battery_update_callback(battery_update_callback);
-
-    // 立即获取一次电池信息
-    g_battery_info = battery_service::get_battery_info();
+    PageScope &scope = PageScope::of(time_page);
+    scope.createTimer(lvgl_time_update_cb, 1000, NULL);
+
+    // 注册系统时间回调和电池状态回调；页面不可见时注销，恢复时重新注册并获取一次电池信息
+    // 定时器和服务回调记录在页面资源作用域中，页面删除时统一释放
+    scope.addSubscription([]() {
+        time_service::set_time_update_callback(time_update_callback);
+        battery_service::set_battery_update_callback(battery_update_callback);
+        g_battery_info = battery_service::get_battery_info();
+    }, []() {
+        time_service::remove_time_update_callback();
+        battery_service::remove_battery_update_callback();
+    });
 
     // 立即更新一次UI
     lvgl_time_update_cb(NULL);
 
     ESP_LOGI(TAG, "Time page created with LVGL timer and battery service");
 
-    //lv_obj_set_user_data(time_page, time_update_timer);// 本页面使用删除回调删除定时器，不使用页面管理器删除
     return time_page;
 }
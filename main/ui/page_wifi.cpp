@@ -1,5 +1,6 @@
 #include "lvgl/lvgl.h"
 #include "page_manager.h"
+#include "page_scope.h"
 #include "pages_common.h"
 #include "system/wifi_manager.h"
 #include "system/esp_log.h"
@@ -12,11 +13,10 @@ extern PageManager g_pageManager;
 static const char *TAG = "page_wifi";
 
 // WiFi页面相关的静态变量
+static lv_obj_t *page_screen = NULL;             // 页面屏幕（定时器和回调记录在其资源作用域中）
 static lv_obj_t *wifi_list = NULL;               // WiFi列表容器
 static lv_obj_t *status_label = NULL;            // 状态标签
 static lv_obj_t *refresh_btn = NULL;             // 刷新按钮
-static lv_timer_t *scan_timer = NULL;            // 扫描定时器
-static lv_timer_t *status_update_timer = NULL;   // 状态更新定时器
 static char connected_ssid[WIFI_MANAGER_MAX_SSID_LEN] = {0}; // 当前连接的SSID
 
 // WiFi状态更新相关变量（线程安全）
@@ -33,21 +33,7 @@ static void status_update_timer_cb(lv_timer_t *timer);
  * 返回按钮回调函数
  */
 static void screen_backbtn_cb(lv_event_t * e) {
-    // 停止扫描定时器
-    if (scan_timer) {
-        lv_timer_del(scan_timer);
-        scan_timer = NULL;
-    }
-
-    // 停止状态更新定时器
-    if (status_update_timer) {
-        lv_timer_del(status_update_timer);
-        status_update_timer = NULL;
-    }
-
-    // 注销状态回调
-    wifi_manager_unregister_status_callback();
-
+    // 定时器和状态回调由页面资源作用域在页面删除时释放，缓存期间由页面管理器暂停
     g_pageManager.back(LV_SCR_LOAD_ANIM_FADE_OUT, 300);
 }
 
@@ -248,7 +234,7 @@ static void refresh_wifi_list(void) {
     }
 
     // 延迟获取扫描结果
-    lv_timer_t *result_timer = lv_timer_create([](lv_timer_t *t) {
+    lv_timer_t *result_timer = PageScope::of(page_screen).createTimer([](lv_timer_t *t) {
         wifi_manager_ap_info_t ap_list[WIFI_MANAGER_MAX_SCAN_RESULTS];
         uint16_t ap_count = 0;
 
@@ -368,8 +354,8 @@ static void refresh_wifi_list(void) {
             }
         }
 
-        // 删除此定时器
-        lv_timer_del(t);
+        // 删除此定时器（同时从页面资源作用域中移除）
+        PageScope::of(page_screen).deleteTimer(t);
     }, 2000, NULL);
 
     lv_timer_set_repeat_count(result_timer, 1);
@@ -379,6 +365,7 @@ static void refresh_wifi_list(void) {
  * 创建WiFi页面
  */
 lv_obj_t* createPage_wifi(void) {
+    TRACE_FUNC();
     ESP_LOGI(TAG, "Creating WiFi page");
 
     // 获取当前连接的SSID
@@ -392,6 +379,8 @@ lv_obj_t* createPage_wifi(void) {
 
     lv_obj_t *wifi_page = lv_obj_create(NULL);
     lv_obj_set_style_bg_color(wifi_page, lv_color_hex(0xF0F0F0), 0);
+    page_screen = wifi_page;
+    PageScope &scope = PageScope::of(wifi_page);
 
     // 主容器
     lv_obj_t *main_container = lv_obj_create(wifi_page);
@@ -455,11 +444,16 @@ lv_obj_t* createPage_wifi(void) {
     lv_obj_set_scrollbar_mode(wifi_list, LV_SCROLLBAR_MODE_AUTO);
     lv_obj_align_to(wifi_list, status_label, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 10);
 
-    // 注册WiFi状态回调
-    wifi_manager_register_status_callback(wifi_status_callback);
+    // 注册WiFi状态回调；页面不可见时注销，恢复时重新注册并同步一次期间错过的状态
+    scope.addSubscription([]() {
+        wifi_manager_register_status_callback(wifi_status_callback);
+        char ssid[WIFI_MANAGER_MAX_SSID_LEN];
+        wifi_manager_get_connected_ssid(ssid, sizeof(ssid));
+        wifi_status_callback(wifi_manager_get_status(), ssid[0] ? ssid : NULL);
+    }, []() { wifi_manager_unregister_status_callback(); });
 
     // 创建状态更新定时器（100ms间隔检查状态变化）
-    status_update_timer = lv_timer_create(status_update_timer_cb, 100, NULL);
+    lv_timer_t *status_update_timer = scope.createTimer(status_update_timer_cb, 100, NULL);
     if (!status_update_timer) {
         ESP_LOGE(TAG, "Failed to create status update timer");
     }
@@ -481,7 +475,7 @@ lv_obj_t* createPage_wifi(void) {
         refresh_wifi_list();
 
         // 设置定期扫描定时器（每30秒扫描一次）
-        scan_timer = lv_timer_create(scan_timer_cb, 30000, NULL);
+        scope.createTimer(scan_timer_cb, 30000, NULL);
     }
 
     return wifi_page;
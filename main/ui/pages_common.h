@@ -1,5 +1,6 @@
 #pragma once
 #include "lvgl/lvgl.h"
+#include "system/trace.h"
 
 #define MY_SYMBOL_CONNECTED "\xEF\x83\x81"
 #define MY_SYMBOL_DISCONNECTED "\xEF\x84\xA7"
@@ -15,15 +16,28 @@
 #define MY_SYMBOL_PHONE "\xEF\x8F\x8D"
 #define MY_SYMBOL_BELL "\xEF\x83\xB3"
 
+// 分步构建的页面工厂函数通过PageBuilder延后执行各区域（见page_manager.h）
+class PageBuilder;
+struct PageState;
 
 lv_obj_t* createPage1();
 lv_obj_t* createPage2();
-lv_obj_t* createPage_settings();
+lv_obj_t* createPage_settings(PageBuilder& builder);
 lv_obj_t* createPage_menu();
-lv_obj_t* createPage_mpu6050();
-lv_obj_t* createPage_qmc5883l();
+lv_obj_t* createPage_mpu6050(PageBuilder& builder);
+lv_obj_t* createPage_qmc5883l(PageBuilder& builder);
 lv_obj_t* createPage_prepage();
 lv_obj_t* createPage_time();
 lv_obj_t* createPage_wifi();
 lv_obj_t* createPage_pmu();
 lv_obj_t* createPage_sd_files();
+
+// 页面生命周期回调（见PageHooks）
+void pausePage_mpu6050(lv_obj_t* page);
+void resumePage_mpu6050(lv_obj_t* page);
+void pausePage_qmc5883l(lv_obj_t* page);
+void resumePage_qmc5883l(lv_obj_t* page);
+void savePage_mpu6050(lv_obj_t* page, PageState& state);
+void restorePage_mpu6050(lv_obj_t* page, const PageState& state);
+void savePage_sd_files(lv_obj_t* page, PageState& state);
+void restorePage_sd_files(lv_obj_t* page, const PageState& state);
@@ -11,6 +11,7 @@ static void lottie_anim_completed_cb(lv_anim_t *a)
 
 lv_obj_t* createPage_prepage(void)
 {
+    TRACE_FUNC();
     // 声明Lottie动画数据
     // extern const uint8_t lv_example_lottie_approve[];
     // extern const size_t lv_example_lottie_approve_size;
@@ -1,4 +1,5 @@
 #include "battery_service.h"
+#include "service_lock.h"
 #include <cstdlib>
 #include <ctime>
 
@@ -11,18 +12,21 @@ static LowBatteryConfig battery_config = {5, 15, true};
 static bool service_initialized = false;
 
 bool init() {
+    SERVICE_LOCK();
     service_initialized = true;
     srand(time(nullptr));
     return true;
 }
 
 void deinit() {
+    SERVICE_LOCK();
     service_initialized = false;
     battery_callback = nullptr;
     warning_callback = nullptr;
 }
 
 BatteryInfo get_battery_info() {
+    SERVICE_LOCK();
     if (!service_initialized) {
         return {0, false, false, 0, false};
     }
@@ -44,30 +48,37 @@ BatteryInfo get_battery_info() {
 }
 
 void set_battery_update_callback(BatteryUpdateCallback callback) {
+    SERVICE_LOCK();
     battery_callback = callback;
 }
 
 void remove_battery_update_callback() {
+    SERVICE_LOCK();
     battery_callback = nullptr;
 }
 
 void set_low_battery_warning_callback(LowBatteryWarningCallback callback) {
+    SERVICE_LOCK();
     warning_callback = callback;
 }
 
 void configure_low_battery_shutdown(const LowBatteryConfig& config) {
+    SERVICE_LOCK();
     battery_config = config;
 }
 
 LowBatteryConfig get_low_battery_config() {
+    SERVICE_LOCK();
     return battery_config;
 }
 
 bool is_available() {
+    SERVICE_LOCK();
     return service_initialized;
 }
 
 void update_battery_info() {
+    SERVICE_LOCK();
     if (!service_initialized) return;
 
     BatteryInfo info = get_battery_info();
@@ -0,0 +1,177 @@
+// dir_loader.cpp
+#include "dir_loader.hpp"
+#include "esp_log.h"
+#include <chrono>
+
+static const char *TAG = "DirLoader";
+
+
+DirLoader& DirLoader::instance() {
+    static DirLoader loader;
+    return loader;
+}
+
+DirLoader::~DirLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        current_id = 0;
+    }
+    cond.notify_all();
+    if (worker.joinable()) worker.join();
+    for (Batch& b : queue) fs_dir_list_free(&b.list);
+}
+
+void DirLoader::setNotify(void (*cb)(void)) {
+    std::lock_guard<std::mutex> lock(mutex);
+    notify = cb;
+}
+
+uint32_t DirLoader::start(const char* path, sort_type_t sort, uint32_t flags, BatchCb cb) {
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = ++current_id;
+        if (id == 0) id = ++current_id;
+        request = Request{id, path ? path : "", sort, flags};
+        has_request = true;
+        // 旧加载的批次不再需要
+        for (Batch& b : queue) fs_dir_list_free(&b.list);
+        queue.clear();
+        if (!worker.joinable()) {
+            worker = std::thread(&DirLoader::workerMain, this);
+        }
+    }
+    callback = std::move(cb);
+    callback_id = id;
+    cond.notify_all();
+    return id;
+}
+
+void DirLoader::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        current_id++;
+        has_request = false;
+        for (Batch& b : queue) fs_dir_list_free(&b.list);
+        queue.clear();
+    }
+    callback = nullptr;
+    callback_id = 0;
+}
+
+bool DirLoader::busy() {
+    return callback_id != 0;
+}
+
+bool DirLoader::dispatch() {
+    bool delivered = false;
+    for (;;) {
+        Batch batch{};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queue.empty()) break;
+            batch = queue.front();
+            queue.pop_front();
+        }
+        // 回调里可能开始新的加载或取消，用局部副本调用
+        if (batch.id == callback_id && callback) {
+            BatchCb cb = callback;
+            if (batch.done) {
+                callback = nullptr;
+                callback_id = 0;
+            }
+            cb(&batch.list, batch.done, batch.status, batch.from_cache);
+            delivered = true;
+        }
+        fs_dir_list_free(&batch.list);
+    }
+    return delivered;
+}
+
+void DirLoader::workerMain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        cond.wait(lock, [this] { return stopping || has_request; });
+        if (stopping) return;
+        Request req = request;
+        has_request = false;
+        lock.unlock();
+        load(req);
+        lock.lock();
+    }
+}
+
+bool DirLoader::isCurrent(uint32_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return id == current_id;
+}
+
+bool DirLoader::post(Batch& batch) {
+    void (*cb)(void);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (batch.id != current_id) {
+            fs_dir_list_free(&batch.list);
+            return false;
+        }
+        queue.push_back(batch);
+        cb = notify;
+    }
+    if (cb) cb();
+    return true;
+}
+
+void DirLoader::load(const Request& req) {
+    using clock = std::chrono::steady_clock;
+    auto t_start = clock::now();
+
+    // 目录缓存命中时一次交出完整列表
+    Batch cached{req.id, {}, true, ESP_OK, true};
+    if (fs_dir_cache_lookup(req.path.c_str(), req.sort, req.flags, &cached.list) == ESP_OK) {
+        post(cached);
+        return;
+    }
+
+    dir_iterator_t it;
+    esp_err_t ret = fs_open_directory(req.path.c_str(), &it);
+    if (ret != ESP_OK) {
+        Batch batch{req.id, {}, true, ret, false};
+        post(batch);
+        return;
+    }
+
+    uint32_t batch_size = BATCH_FIRST;
+    uint32_t total = 0;
+    bool done = false;
+    while (!done) {
+        Batch batch{req.id, {}, false, ESP_OK, false};
+        auto t_batch = clock::now();
+        // 小块读取，读满一批或超时就交出
+        while (batch.list.count < batch_size) {
+            uint32_t chunk = batch_size - batch.list.count < BATCH_FIRST ? batch_size - batch.list.count : BATCH_FIRST;
+            ret = fs_read_next_batch(&it, req.flags, &batch.list, chunk);
+            if (ret != ESP_OK) {
+                done = true;
+                break;
+            }
+            if (clock::now() - t_batch >= std::chrono::milliseconds(BATCH_MAX_MS)) break;
+            if (!isCurrent(req.id)) break;
+        }
+        fs_dir_list_sort(&batch.list, req.sort);
+        total += batch.list.count;
+        batch.done = done;
+        batch.status = (ret == ESP_OK || ret == ESP_ERR_NOT_FOUND) ? ESP_OK : ret;
+        if (!post(batch)) {
+            ESP_LOGI(TAG, "Load of %s cancelled after %u entries", req.path.c_str(), (unsigned)total);
+            break;
+        }
+        if (batch_size < BATCH_LIMIT) batch_size *= 2;
+    }
+    fs_close_directory(&it);
+
+    if (done) {
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - t_start).count();
+        ESP_LOGI(TAG, "Loaded %u entries from %s in %lld ms", (unsigned)total, req.path.c_str(), (long long)ms);
+    }
+}
@@ -0,0 +1,90 @@
+// dir_loader.hpp
+// 后台目录加载：工作线程分批读取目录，每批排好序放入队列，由UI线程在主循环中取出交给回调
+//
+// SD卡上的readdir/stat很慢，在LVGL线程上列目录会卡住界面。第一批很小（约一屏），之后批次逐渐变大，
+// 读取超过BATCH_MAX_MS也会提前交出一批，界面先显示第一屏再逐步补全。
+// 目录缓存（fs_dir_cache_lookup）命中时直接交出一批完整列表；未命中时完整列表由调用方在最后一批后存入缓存。
+// 开始新的加载或cancel()会取消之前的加载：未交付的批次被丢弃，回调不再调用；
+// 工作线程在当前批次读完后放弃旧目录。
+#pragma once
+#include "filesystem_service.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+class DirLoader {
+public:
+    // 在UI线程调用；batch为本批（已按sort排序，回调返回后释放），done为true时是最后一批，
+    // status为结束状态：ESP_OK或读取错误（此时batch可能为空）；
+    // from_cache为true时本批是目录缓存中的完整列表，调用方不需要再存入缓存
+    using BatchCb = std::function<void(const fs_dir_list_t* batch, bool done, esp_err_t status, bool from_cache)>;
+
+    static constexpr uint32_t BATCH_FIRST = 16;      // 第一批的项数
+    static constexpr uint32_t BATCH_LIMIT = 4096;    // 批次项数上限
+    static constexpr uint32_t BATCH_MAX_MS = 30;     // 一批最长读取时间
+
+    static DirLoader& instance();
+
+    DirLoader(const DirLoader&) = delete;
+    DirLoader& operator=(const DirLoader&) = delete;
+
+    // 批次入队后调用的唤醒函数（如main_wait_notify），在工作线程调用
+    void setNotify(void (*cb)(void));
+
+    // 开始加载path，取消之前的加载；返回本次加载的编号
+    uint32_t start(const char* path, sort_type_t sort, uint32_t flags, BatchCb cb);
+    // 取消当前加载
+    void cancel();
+    // 是否有加载尚未交付最后一批
+    bool busy();
+
+    // UI线程调用：把队列中的批次交给回调；交付了批次时返回true
+    bool dispatch();
+
+private:
+    DirLoader() = default;
+    ~DirLoader();
+
+    struct Request {
+        uint32_t id;
+        std::string path;
+        sort_type_t sort;
+        uint32_t flags;
+    };
+
+    struct Batch {
+        uint32_t id;
+        fs_dir_list_t list;
+        bool done;
+        esp_err_t status;
+        bool from_cache;
+    };
+
+    void workerMain();
+    // 读取一个目录，每批入队；被新的请求取消时提前返回
+    void load(const Request& req);
+    bool isCurrent(uint32_t id);
+    // 入队并唤醒主循环；加载已被取消时释放批次并返回false
+    bool post(Batch& batch);
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread worker;
+    bool stopping = false;
+
+    // 以下受mutex保护
+    uint32_t current_id = 0;            // 最新的加载编号，0为没有加载
+    bool has_request = false;
+    Request request;
+    std::deque<Batch> queue;
+    void (*notify)(void) = nullptr;
+
+    // 只在UI线程访问
+    BatchCb callback;
+    uint32_t callback_id = 0;
+};
@@ -3,7 +3,11 @@
 #include <cstdlib>
 #include <ctime>
 #include <cstdio>
+#include <cerrno>
 #include <algorithm>
+#include <list>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #ifdef _WIN32
@@ -14,6 +18,7 @@
 #pragma comment(lib, "shlwapi.lib")
 #else
 #include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
@@ -42,6 +47,43 @@ static time_t filetime_to_time_t(const FILETIME *ft) {
 }
 #endif
 
+#ifndef _WIN32
+static void stamp_from_stat(const struct stat *st, fs_dir_stamp_t *stamp) {
+    stamp->dev = (uint64_t)st->st_dev;
+    stamp->ino = (uint64_t)st->st_ino;
+#ifdef __linux__
+    stamp->mtime_ns = (int64_t)st->st_mtim.tv_sec * 1000000000 + st->st_mtim.tv_nsec;
+#else
+    stamp->mtime_ns = (int64_t)st->st_mtime * 1000000000;
+#endif
+    stamp->valid = true;
+}
+#endif
+
+// 按路径取目录标识，失败时stamp->valid为false
+static void get_dir_stamp(const char *path, fs_dir_stamp_t *stamp) {
+    memset(stamp, 0, sizeof(*stamp));
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (GetFileAttributesExA(path, GetFileExInfoStandard, &data)) {
+        ULARGE_INTEGER ui;
+        ui.LowPart = data.ftLastWriteTime.dwLowDateTime;
+        ui.HighPart = data.ftLastWriteTime.dwHighDateTime;
+        stamp->mtime_ns = (int64_t)ui.QuadPart * 100;
+        stamp->valid = true;
+    }
+#else
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        stamp_from_stat(&st, stamp);
+    }
+#endif
+}
+
+static bool stamp_equal(const fs_dir_stamp_t *a, const fs_dir_stamp_t *b) {
+    return a->valid && b->valid && a->dev == b->dev && a->ino == b->ino && a->mtime_ns == b->mtime_ns;
+}
+
 // 实际的路径存在检查
 bool fs_is_path_exists(const char *path) {
     if (!filesystem_initialized || !path) return false;
@@ -102,104 +144,21 @@ esp_err_t fs_list_directory(const char* path, file_info_t **files, int *count, s
     // 临时存储文件列表
     std::vector<file_info_t> file_list;
 
-#ifdef _WIN32
-    WIN32_FIND_DATAA find_data;
-    HANDLE find_handle;
-
-    // 构建搜索模式
-    char search_pattern[MAX_PATH_LEN];
-    snprintf(search_pattern, sizeof(search_pattern), "%s\\*", path);
-
-    find_handle = FindFirstFileA(search_pattern, &find_data);
-    if (find_handle == INVALID_HANDLE_VALUE) {
-        return ESP_ERR_NOT_FOUND;
+    dir_iterator_t it;
+    esp_err_t ret = fs_open_directory(path, &it);
+    if (ret != ESP_OK) {
+        return ret;
     }
 
-    do {
-        // 跳过当前目录和父目录引用
-        if (strcmp(find_data.cFileName, ".") == 0 || strcmp(find_data.cFileName, "..") == 0) {
-            continue;
-        }
-
-        file_info_t file_info = {};
-
-        // 设置文件名
-        strncpy(file_info.name, find_data.cFileName, sizeof(file_info.name) - 1);
-
-        // 设置完整路径
-        snprintf(file_info.full_path, sizeof(file_info.full_path), "%s\\%s", path, find_data.cFileName);
-
-        // 设置文件类型
-        if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
-            file_info.type = FILE_TYPE_DIRECTORY;
-            file_info.size = 0;
-        } else {
-            file_info.type = FILE_TYPE_REGULAR;
-            LARGE_INTEGER file_size;
-            file_size.LowPart = find_data.nFileSizeLow;
-            file_size.HighPart = find_data.nFileSizeHigh;
-            file_info.size = file_size.QuadPart;
-        }
-
-        // 设置修改时间
-        file_info.modified_time = filetime_to_time_t(&find_data.ftLastWriteTime);
-
-        // 设置隐藏属性
-        file_info.is_hidden = (find_data.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0;
-
+    file_info_t file_info;
+    while ((ret = fs_read_next_file(&it, &file_info)) == ESP_OK) {
         file_list.push_back(file_info);
-
-    } while (FindNextFileA(find_handle, &find_data));
-
-    FindClose(find_handle);
-
-#else // Linux/Unix实现
-    DIR *dir = opendir(path);
-    if (!dir) {
-        return ESP_ERR_NOT_FOUND;
     }
-
-    struct dirent *entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        // 跳过当前目录和父目录引用
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-            continue;
-        }
-
-        file_info_t file_info = {};
-
-        // 设置文件名
-        strncpy(file_info.name, entry->d_name, sizeof(file_info.name) - 1);
-
-        // 设置完整路径
-        snprintf(file_info.full_path, sizeof(file_info.full_path), "%s/%s", path, entry->d_name);
-
-        // 获取文件详细信息
-        struct stat file_stat;
-        if (stat(file_info.full_path, &file_stat) == 0) {
-            if (S_ISDIR(file_stat.st_mode)) {
-                file_info.type = FILE_TYPE_DIRECTORY;
-                file_info.size = 0;
-            } else {
-                file_info.type = FILE_TYPE_REGULAR;
-                file_info.size = file_stat.st_size;
-            }
-            file_info.modified_time = file_stat.st_mtime;
-        } else {
-            file_info.type = FILE_TYPE_UNKNOWN;
-            file_info.size = 0;
-            file_info.modified_time = 0;
-        }
-
-        // 设置隐藏属性（Unix系统中以.开头的文件被认为是隐藏的）
-        file_info.is_hidden = (entry->d_name[0] == '.');
-
-        file_list.push_back(file_info);
+    fs_close_directory(&it);
+    if (ret != ESP_ERR_NOT_FOUND) {
+        return ret;
     }
 
-    closedir(dir);
-#endif
-
     // 排序文件列表
     switch (sort) {
         case SORT_BY_NAME_ASC:
@@ -254,6 +213,7 @@ esp_err_t fs_list_directory(const char* path, file_info_t **files, int *count, s
     if (*count > 0) {
         *files = (file_info_t*)malloc(*count * sizeof(file_info_t));
         if (!*files) {
+            *count = 0;
             return ESP_ERR_NO_MEM;
         }
 
@@ -271,23 +231,655 @@ void fs_free_file_list(file_info_t *files, int count) {
     }
 }
 
+#ifdef _WIN32
+// Windows的查找句柄和预读的第一项，放在模拟的DIR后面一起分配
+typedef struct {
+    DIR dir;
+    HANDLE find_handle;
+    WIN32_FIND_DATAA find_data;
+    bool has_data;      // find_data中有一项尚未返回
+} win_dir_t;
+#endif
+
+// 目录遍历：每次只读取一项，内存占用与目录大小无关
 esp_err_t fs_open_directory(const char *path, dir_iterator_t *iterator) {
     if (!iterator) return ESP_ERR_INVALID_ARG;
     iterator->dir_handle = nullptr;
-    strcpy(iterator->current_path, path ? path : "/sd");
+    iterator->current_path[0] = '\0';
     iterator->file_count = 0;
     iterator->dir_count = 0;
+    memset(&iterator->stamp, 0, sizeof(iterator->stamp));
+    if (!filesystem_initialized || !path) return ESP_ERR_INVALID_ARG;
+
+    size_t len = strlen(path);
+    if (len >= sizeof(iterator->current_path)) return ESP_ERR_INVALID_SIZE;
+    memcpy(iterator->current_path, path, len + 1);
+
+#ifdef _WIN32
+    char search_pattern[MAX_PATH_LEN];
+    snprintf(search_pattern, sizeof(search_pattern), "%s\\*", path);
+
+    win_dir_t *wd = (win_dir_t*)calloc(1, sizeof(win_dir_t));
+    if (!wd) return ESP_ERR_NO_MEM;
+    wd->find_handle = FindFirstFileA(search_pattern, &wd->find_data);
+    if (wd->find_handle == INVALID_HANDLE_VALUE) {
+        free(wd);
+        return ESP_ERR_NOT_FOUND;
+    }
+    wd->has_data = true;
+    wd->dir.handle = wd->find_handle;
+    iterator->dir_handle = &wd->dir;
+    get_dir_stamp(path, &iterator->stamp);
+#else
+    DIR *dir = opendir(path);
+    if (!dir) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    iterator->dir_handle = dir;
+    // 读取前记录目录标识，读取期间目录的变化会使缓存项失效
+    struct stat st;
+    if (fstat(dirfd(dir), &st) == 0) {
+        stamp_from_stat(&st, &iterator->stamp);
+    }
+#endif
     return ESP_OK;
 }
 
+// 读取下一项（跳过.和..），没有更多文件时返回ESP_ERR_NOT_FOUND
 esp_err_t fs_read_next_file(dir_iterator_t *iterator, file_info_t *file_info) {
-    return ESP_ERR_NOT_FOUND; // 模拟没有更多文件
+    if (!iterator || !file_info) return ESP_ERR_INVALID_ARG;
+    if (!iterator->dir_handle) return ESP_ERR_INVALID_STATE;
+
+#ifdef _WIN32
+    win_dir_t *wd = (win_dir_t*)iterator->dir_handle;
+    for (;;) {
+        if (!wd->has_data) {
+            if (!FindNextFileA(wd->find_handle, &wd->find_data)) {
+                return ESP_ERR_NOT_FOUND;
+            }
+        }
+        wd->has_data = false;
+
+        const WIN32_FIND_DATAA &fd = wd->find_data;
+        // 跳过当前目录和父目录引用
+        if (strcmp(fd.cFileName, ".") == 0 || strcmp(fd.cFileName, "..") == 0) {
+            continue;
+        }
+
+        memset(file_info, 0, sizeof(*file_info));
+        // 完整路径超出缓冲区的条目无法再打开，跳过
+        int len = snprintf(file_info->full_path, sizeof(file_info->full_path), "%s\\%s", iterator->current_path, fd.cFileName);
+        if (len < 0 || (size_t)len >= sizeof(file_info->full_path)) {
+            continue;
+        }
+        strncpy(file_info->name, fd.cFileName, sizeof(file_info->name) - 1);
+
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            file_info->type = FILE_TYPE_DIRECTORY;
+            file_info->size = 0;
+        } else {
+            file_info->type = FILE_TYPE_REGULAR;
+            LARGE_INTEGER file_size;
+            file_size.LowPart = fd.nFileSizeLow;
+            file_size.HighPart = fd.nFileSizeHigh;
+            file_info->size = file_size.QuadPart;
+        }
+        file_info->modified_time = filetime_to_time_t(&fd.ftLastWriteTime);
+        file_info->is_hidden = (fd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0;
+        break;
+    }
+#else
+    DIR *dir = iterator->dir_handle;
+    struct dirent *entry;
+    for (;;) {
+        errno = 0;
+        entry = readdir(dir);
+        if (!entry) {
+            return errno ? ESP_FAIL : ESP_ERR_NOT_FOUND;
+        }
+        // 跳过当前目录和父目录引用
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        memset(file_info, 0, sizeof(*file_info));
+        // 完整路径超出缓冲区的条目无法再打开，跳过
+        int len = snprintf(file_info->full_path, sizeof(file_info->full_path), "%s/%s", iterator->current_path, entry->d_name);
+        if (len < 0 || (size_t)len >= sizeof(file_info->full_path)) {
+            continue;
+        }
+        break;
+    }
+
+    strncpy(file_info->name, entry->d_name, sizeof(file_info->name) - 1);
+
+    // 相对目录句柄取文件信息，不需要内核重新解析完整路径
+    struct stat file_stat;
+    if (fstatat(dirfd(dir), entry->d_name, &file_stat, 0) == 0) {
+        if (S_ISDIR(file_stat.st_mode)) {
+            file_info->type = FILE_TYPE_DIRECTORY;
+            file_info->size = 0;
+        } else {
+            file_info->type = FILE_TYPE_REGULAR;
+            file_info->size = file_stat.st_size;
+        }
+        file_info->modified_time = file_stat.st_mtime;
+    } else {
+        file_info->type = FILE_TYPE_UNKNOWN;
+        file_info->size = 0;
+        file_info->modified_time = 0;
+    }
+
+    // 设置隐藏属性（Unix系统中以.开头的文件被认为是隐藏的）
+    file_info->is_hidden = (entry->d_name[0] == '.');
+#endif
+
+    if (file_info->type == FILE_TYPE_DIRECTORY) {
+        iterator->dir_count++;
+    } else {
+        iterator->file_count++;
+    }
+    return ESP_OK;
 }
 
 void fs_close_directory(dir_iterator_t *iterator) {
-    if (iterator) {
-        iterator->dir_handle = nullptr;
+    if (!iterator || !iterator->dir_handle) return;
+#ifdef _WIN32
+    win_dir_t *wd = (win_dir_t*)iterator->dir_handle;
+    FindClose(wd->find_handle);
+    free(wd);
+#else
+    closedir(iterator->dir_handle);
+#endif
+    iterator->dir_handle = nullptr;
+}
+
+// ---- 紧凑目录列表 ----
+
+// 按需扩大各数组，失败时保持原数组
+static bool dir_list_reserve(fs_dir_list_t *list, uint32_t want_size, bool with_size, bool with_time) {
+    if (list->count < list->cap && want_size <= list->names_cap - list->names_used &&
+        (!with_size || list->size) && (!with_time || list->mtime)) {
+        return true;
+    }
+
+    if (want_size > list->names_cap - list->names_used) {
+        uint32_t cap = list->names_cap ? list->names_cap : 4096;
+        while (cap - list->names_used < want_size) cap *= 2;
+        char *names = (char*)realloc(list->names, cap);
+        if (!names) return false;
+        list->names = names;
+        list->names_cap = cap;
+    }
+
+    uint32_t cap = list->cap;
+    if (list->count == cap) {
+        cap = cap ? cap * 2 : 64;
+        uint32_t *name_offset = (uint32_t*)realloc(list->name_offset, cap * sizeof(uint32_t));
+        if (!name_offset) return false;
+        list->name_offset = name_offset;
+        uint32_t *order = (uint32_t*)realloc(list->order, cap * sizeof(uint32_t));
+        if (!order) return false;
+        list->order = order;
+        uint8_t *type = (uint8_t*)realloc(list->type, cap);
+        if (!type) return false;
+        list->type = type;
+    }
+    // 大小/时间数组在第一次需要时分配，之前的项为0
+    if (with_size || list->size) {
+        uint64_t *size = (uint64_t*)realloc(list->size, cap * sizeof(uint64_t));
+        if (!size) return false;
+        if (!list->size) memset(size, 0, list->count * sizeof(uint64_t));
+        list->size = size;
     }
+    if (with_time || list->mtime) {
+        time_t *mtime = (time_t*)realloc(list->mtime, cap * sizeof(time_t));
+        if (!mtime) return false;
+        if (!list->mtime) memset(mtime, 0, list->count * sizeof(time_t));
+        list->mtime = mtime;
+    }
+    list->cap = cap;
+    return true;
+}
+
+// 追加一项，排序位置暂时等于读取顺序
+static bool dir_list_push(fs_dir_list_t *list, const char *name, uint8_t type,
+                          const uint64_t *size, const time_t *mtime) {
+    uint32_t name_size = (uint32_t)strlen(name) + 1;
+    if (!dir_list_reserve(list, name_size, size != nullptr, mtime != nullptr)) {
+        return false;
+    }
+    uint32_t i = list->count++;
+    list->name_offset[i] = list->names_used;
+    memcpy(list->names + list->names_used, name, name_size);
+    list->names_used += name_size;
+    list->type[i] = type;
+    list->order[i] = i;
+    if (list->size) list->size[i] = size ? *size : 0;
+    if (list->mtime) list->mtime[i] = mtime ? *mtime : 0;
+    return true;
+}
+
+// 用排序方式对应的比较函数调用f
+template<typename F>
+static void dir_list_with_compare(const fs_dir_list_t *list, sort_type_t sort, F &&f) {
+    switch (sort) {
+        case SORT_BY_NAME_ASC:
+            f([list](uint32_t a, uint32_t b) {
+                return strcmp(list->names + list->name_offset[a], list->names + list->name_offset[b]) < 0;
+            });
+            break;
+        case SORT_BY_NAME_DESC:
+            f([list](uint32_t a, uint32_t b) {
+                return strcmp(list->names + list->name_offset[a], list->names + list->name_offset[b]) > 0;
+            });
+            break;
+        case SORT_BY_SIZE_ASC:
+            f([list](uint32_t a, uint32_t b) {
+                return list->size[a] < list->size[b];
+            });
+            break;
+        case SORT_BY_SIZE_DESC:
+            f([list](uint32_t a, uint32_t b) {
+                return list->size[a] > list->size[b];
+            });
+            break;
+        case SORT_BY_TIME_ASC:
+            f([list](uint32_t a, uint32_t b) {
+                return list->mtime[a] < list->mtime[b];
+            });
+            break;
+        case SORT_BY_TIME_DESC:
+            f([list](uint32_t a, uint32_t b) {
+                return list->mtime[a] > list->mtime[b];
+            });
+            break;
+        case SORT_BY_TYPE:
+            f([list](uint32_t a, uint32_t b) {
+                int ta = list->type[a] & FS_ENTRY_TYPE_MASK;
+                int tb = list->type[b] & FS_ENTRY_TYPE_MASK;
+                if (ta != tb) {
+                    return ta < tb; // 目录优先
+                }
+                return strcmp(list->names + list->name_offset[a], list->names + list->name_offset[b]) < 0;
+            });
+            break;
+    }
+}
+
+static bool sort_needs_size(sort_type_t sort) {
+    return sort == SORT_BY_SIZE_ASC || sort == SORT_BY_SIZE_DESC;
+}
+
+static bool sort_needs_time(sort_type_t sort) {
+    return sort == SORT_BY_TIME_ASC || sort == SORT_BY_TIME_DESC;
+}
+
+esp_err_t fs_read_next_batch(dir_iterator_t *iterator, uint32_t flags, fs_dir_list_t *list, uint32_t max_count) {
+    if (!iterator || !list) return ESP_ERR_INVALID_ARG;
+    if (!iterator->dir_handle) return ESP_ERR_INVALID_STATE;
+    if (list->path[0] == '\0') {
+        memcpy(list->path, iterator->current_path, sizeof(list->path));
+        list->stamp = iterator->stamp;
+    }
+
+    const bool with_size = (flags & FS_LIST_SIZE) != 0;
+    const bool with_time = (flags & FS_LIST_TIME) != 0;
+    const bool skip_hidden = (flags & FS_LIST_SKIP_HIDDEN) != 0;
+
+    for (uint32_t n = 0; n < max_count; ) {
+        const char *name;
+        bool hidden;
+        file_type_t type = FILE_TYPE_UNKNOWN;
+        uint64_t size = 0;
+        time_t mtime = 0;
+
+#ifdef _WIN32
+        win_dir_t *wd = (win_dir_t*)iterator->dir_handle;
+        if (!wd->has_data) {
+            if (!FindNextFileA(wd->find_handle, &wd->find_data)) {
+                return ESP_ERR_NOT_FOUND;
+            }
+        }
+        wd->has_data = false;
+
+        const WIN32_FIND_DATAA &fd = wd->find_data;
+        name = fd.cFileName;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+            continue;
+        }
+        hidden = (fd.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0;
+        if (hidden && skip_hidden) {
+            continue;
+        }
+        if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            type = FILE_TYPE_DIRECTORY;
+        } else {
+            type = FILE_TYPE_REGULAR;
+            size = ((uint64_t)fd.nFileSizeHigh << 32) | fd.nFileSizeLow;
+        }
+        mtime = filetime_to_time_t(&fd.ftLastWriteTime);
+#else
+        errno = 0;
+        struct dirent *entry = readdir(iterator->dir_handle);
+        if (!entry) {
+            return errno ? ESP_FAIL : ESP_ERR_NOT_FOUND;
+        }
+        name = entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+            continue;
+        }
+        // Unix系统中以.开头的文件被认为是隐藏的
+        hidden = (name[0] == '.');
+        if (hidden && skip_hidden) {
+            continue;
+        }
+
+        bool need_stat = with_time;
+#ifdef DT_DIR
+        // 文件系统给出了类型时不需要stat；符号链接要stat才知道指向什么
+        if (entry->d_type == DT_DIR) {
+            type = FILE_TYPE_DIRECTORY;
+        } else if (entry->d_type == DT_REG) {
+            type = FILE_TYPE_REGULAR;
+            need_stat = need_stat || with_size;
+        } else if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK) {
+            type = FILE_TYPE_REGULAR;
+        } else {
+            need_stat = true;
+        }
+#else
+        need_stat = true;
+#endif
+
+        if (need_stat) {
+            struct stat st;
+            list->stat_calls++;
+            if (fstatat(dirfd(iterator->dir_handle), name, &st, 0) == 0) {
+                type = S_ISDIR(st.st_mode) ? FILE_TYPE_DIRECTORY : FILE_TYPE_REGULAR;
+                size = (type == FILE_TYPE_REGULAR) ? (uint64_t)st.st_size : 0;
+                mtime = st.st_mtime;
+            }
+        }
+#endif
+
+        if (!dir_list_push(list, name, (uint8_t)type | (hidden ? FS_ENTRY_HIDDEN : 0),
+                           with_size ? &size : nullptr, with_time ? &mtime : nullptr)) {
+            return ESP_ERR_NO_MEM;
+        }
+        if (type == FILE_TYPE_DIRECTORY) {
+            iterator->dir_count++;
+        } else {
+            iterator->file_count++;
+        }
+        n++;
+    }
+    return ESP_OK;
+}
+
+void fs_dir_list_sort(fs_dir_list_t *list, sort_type_t sort) {
+    if (!list || list->count < 2) return;
+    dir_list_with_compare(list, sort, [list](auto compare) {
+        std::sort(list->order, list->order + list->count, compare);
+    });
+}
+
+esp_err_t fs_dir_list_merge(fs_dir_list_t *list, const fs_dir_list_t *src, sort_type_t sort) {
+    if (!list || !src) return ESP_ERR_INVALID_ARG;
+    if (list->path[0] == '\0') {
+        memcpy(list->path, src->path, sizeof(list->path));
+        list->stamp = src->stamp;
+    }
+
+    // 按src的排序位置追加，新的项本身已经有序，只需与原有部分归并
+    uint32_t old_count = list->count;
+    for (uint32_t i = 0; i < src->count; i++) {
+        uint32_t j = src->order[i];
+        if (!dir_list_push(list, src->names + src->name_offset[j], src->type[j],
+                           src->size ? &src->size[j] : nullptr, src->mtime ? &src->mtime[j] : nullptr)) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    list->stat_calls += src->stat_calls;
+
+    if (old_count > 0 && src->count > 0) {
+        dir_list_with_compare(list, sort, [list, old_count](auto compare) {
+            std::inplace_merge(list->order, list->order + old_count, list->order + list->count, compare);
+        });
+    }
+    return ESP_OK;
+}
+
+esp_err_t fs_list_directory_compact(const char *path, sort_type_t sort, uint32_t flags, fs_dir_list_t *list) {
+    if (!list) return ESP_ERR_INVALID_ARG;
+    memset(list, 0, sizeof(*list));
+
+    if (sort_needs_size(sort)) flags |= FS_LIST_SIZE;
+    if (sort_needs_time(sort)) flags |= FS_LIST_TIME;
+
+    if (path && fs_dir_cache_lookup(path, sort, flags, list) == ESP_OK) {
+        return ESP_OK;
+    }
+
+    dir_iterator_t it;
+    esp_err_t ret = fs_open_directory(path, &it);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    ret = fs_read_next_batch(&it, flags, list, UINT32_MAX);
+    fs_close_directory(&it);
+    if (ret != ESP_ERR_NOT_FOUND) {
+        fs_dir_list_free(list);
+        return ret == ESP_OK ? ESP_ERR_INVALID_SIZE : ret;
+    }
+
+    fs_dir_list_sort(list, sort);
+    fs_dir_cache_store(path, list, sort, flags);
+    return ESP_OK;
+}
+
+void fs_dir_list_free(fs_dir_list_t *list) {
+    if (!list) return;
+    free(list->names);
+    free(list->name_offset);
+    free(list->type);
+    free(list->size);
+    free(list->mtime);
+    free(list->order);
+    // 路径和目录标识也要清除，否则下一次读入同一个列表时会沿用上一个目录的
+    memset(list, 0, sizeof(*list));
+}
+
+size_t fs_dir_list_memory(const fs_dir_list_t *list) {
+    if (!list) return 0;
+    size_t per_entry = sizeof(uint32_t) * 2 + sizeof(uint8_t)
+                     + (list->size ? sizeof(uint64_t) : 0)
+                     + (list->mtime ? sizeof(time_t) : 0);
+    return list->names_cap + (size_t)list->cap * per_entry;
+}
+
+esp_err_t fs_dir_list_full_path(const fs_dir_list_t *list, uint32_t i, char *result_path, size_t result_size) {
+    if (!list || i >= list->count || !result_path || result_size == 0) return ESP_ERR_INVALID_ARG;
+    return fs_join_path(list->path, fs_dir_list_name(list, i), result_path, result_size);
+}
+
+// ---- 目录列表缓存 ----
+
+typedef struct {
+    std::string path;
+    sort_type_t sort;
+    uint32_t flags;
+    fs_dir_list_t list;
+    size_t bytes;
+} dir_cache_entry_t;
+
+static std::mutex dir_cache_mutex;
+// 以下受dir_cache_mutex保护
+static std::list<dir_cache_entry_t> dir_cache;     // 最近使用的在前
+static size_t dir_cache_bytes = 0;
+static size_t dir_cache_limit = FS_DIR_CACHE_DEFAULT_LIMIT;
+static fs_dir_cache_stats_t dir_cache_counters;
+
+// 按实际大小复制列表（数组不留余量），失败时dst为空
+static bool dir_list_copy(fs_dir_list_t *dst, const fs_dir_list_t *src) {
+    memset(dst, 0, sizeof(*dst));
+    memcpy(dst->path, src->path, sizeof(dst->path));
+    dst->stamp = src->stamp;
+    uint32_t n = src->count;
+    if (n == 0) return true;
+
+    dst->names = (char*)malloc(src->names_used);
+    dst->name_offset = (uint32_t*)malloc(n * sizeof(uint32_t));
+    dst->order = (uint32_t*)malloc(n * sizeof(uint32_t));
+    dst->type = (uint8_t*)malloc(n);
+    if (src->size) dst->size = (uint64_t*)malloc(n * sizeof(uint64_t));
+    if (src->mtime) dst->mtime = (time_t*)malloc(n * sizeof(time_t));
+    if (!dst->names || !dst->name_offset || !dst->order || !dst->type ||
+        (src->size && !dst->size) || (src->mtime && !dst->mtime)) {
+        fs_dir_list_free(dst);
+        return false;
+    }
+
+    memcpy(dst->names, src->names, src->names_used);
+    memcpy(dst->name_offset, src->name_offset, n * sizeof(uint32_t));
+    memcpy(dst->order, src->order, n * sizeof(uint32_t));
+    memcpy(dst->type, src->type, n);
+    if (src->size) memcpy(dst->size, src->size, n * sizeof(uint64_t));
+    if (src->mtime) memcpy(dst->mtime, src->mtime, n * sizeof(time_t));
+    dst->count = n;
+    dst->cap = n;
+    dst->names_used = src->names_used;
+    dst->names_cap = src->names_used;
+    return true;
+}
+
+// 缓存项占用的内存：按实际大小复制后的列表加上项本身
+static size_t dir_cache_entry_bytes(const fs_dir_list_t *list) {
+    size_t per_entry = sizeof(uint32_t) * 2 + sizeof(uint8_t)
+                     + (list->size ? sizeof(uint64_t) : 0)
+                     + (list->mtime ? sizeof(time_t) : 0);
+    return list->names_used + (size_t)list->count * per_entry + sizeof(dir_cache_entry_t) + strlen(list->path);
+}
+
+// 需持有dir_cache_mutex
+static void dir_cache_erase(std::list<dir_cache_entry_t>::iterator it) {
+    dir_cache_bytes -= it->bytes;
+    fs_dir_list_free(&it->list);
+    dir_cache.erase(it);
+}
+
+// 需持有dir_cache_mutex：从最久未用的开始淘汰，直到满足上限
+static void dir_cache_trim(void) {
+    while (!dir_cache.empty() &&
+           (dir_cache_bytes > dir_cache_limit || dir_cache.size() > FS_DIR_CACHE_MAX_ENTRIES)) {
+        dir_cache_erase(std::prev(dir_cache.end()));
+        dir_cache_counters.evictions++;
+    }
+}
+
+esp_err_t fs_dir_cache_lookup(const char *path, sort_type_t sort, uint32_t flags, fs_dir_list_t *list) {
+    if (!path || !list) return ESP_ERR_INVALID_ARG;
+    memset(list, 0, sizeof(*list));
+
+    // 目录标识在锁外获取，stat可能很慢
+    fs_dir_stamp_t now;
+    get_dir_stamp(path, &now);
+
+    std::lock_guard<std::mutex> lock(dir_cache_mutex);
+    for (auto it = dir_cache.begin(); it != dir_cache.end(); ++it) {
+        if (it->sort != sort || it->flags != flags || it->path != path) continue;
+
+        if (!stamp_equal(&it->list.stamp, &now)) {
+            dir_cache_erase(it);
+            dir_cache_counters.stale++;
+            break;
+        }
+        if (!dir_list_copy(list, &it->list)) {
+            break;
+        }
+        dir_cache.splice(dir_cache.begin(), dir_cache, it);
+        dir_cache_counters.hits++;
+        return ESP_OK;
+    }
+    dir_cache_counters.misses++;
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t fs_dir_cache_store(const char *path, const fs_dir_list_t *list, sort_type_t sort, uint32_t flags) {
+    if (!path || !list) return ESP_ERR_INVALID_ARG;
+    // 列表必须是请求的目录读出来的，否则会以错误的键保存
+    if (strcmp(list->path, path) != 0) return ESP_ERR_INVALID_ARG;
+    if (!list->stamp.valid) return ESP_ERR_INVALID_STATE;
+
+    dir_cache_entry_t entry;
+    entry.path = list->path;
+    entry.sort = sort;
+    entry.flags = flags;
+    {
+        std::lock_guard<std::mutex> lock(dir_cache_mutex);
+        for (auto it = dir_cache.begin(); it != dir_cache.end(); ++it) {
+            if (it->sort == sort && it->flags == flags && it->path == entry.path) {
+                dir_cache_erase(it);
+                break;
+            }
+        }
+        if (dir_cache_entry_bytes(list) > dir_cache_limit) {
+            return ESP_ERR_INVALID_SIZE;
+        }
+    }
+
+    // 复制在锁外进行
+    if (!dir_list_copy(&entry.list, list)) return ESP_ERR_NO_MEM;
+    entry.bytes = dir_cache_entry_bytes(&entry.list);
+
+    std::lock_guard<std::mutex> lock(dir_cache_mutex);
+    if (entry.bytes > dir_cache_limit) {
+        fs_dir_list_free(&entry.list);
+        return ESP_ERR_INVALID_SIZE;
+    }
+    dir_cache_bytes += entry.bytes;
+    dir_cache.push_front(std::move(entry));
+    dir_cache_trim();
+    return ESP_OK;
+}
+
+void fs_dir_cache_invalidate(const char *path) {
+    std::lock_guard<std::mutex> lock(dir_cache_mutex);
+    for (auto it = dir_cache.begin(); it != dir_cache.end(); ) {
+        auto next = std::next(it);
+        if (!path || it->path == path) {
+            dir_cache_erase(it);
+        }
+        it = next;
+    }
+}
+
+void fs_dir_cache_set_limit(size_t bytes) {
+    std::lock_guard<std::mutex> lock(dir_cache_mutex);
+    dir_cache_limit = bytes;
+    dir_cache_trim();
+}
+
+void fs_dir_cache_get_stats(fs_dir_cache_stats_t *stats) {
+    if (!stats) return;
+    std::lock_guard<std::mutex> lock(dir_cache_mutex);
+    *stats = dir_cache_counters;
+    stats->entries = (uint32_t)dir_cache.size();
+    stats->bytes = dir_cache_bytes;
+    stats->limit = dir_cache_limit;
+}
+
+void fs_dir_cache_log_stats(void) {
+    fs_dir_cache_stats_t st;
+    fs_dir_cache_get_stats(&st);
+    uint32_t lookups = st.hits + st.misses;
+    printf("Dir cache: %u hits, %u misses (%u stale), %.1f%% hit rate, %u entries, %u/%u KB, %u evictions\n",
+           (unsigned)st.hits, (unsigned)st.misses, (unsigned)st.stale,
+           lookups ? st.hits * 100.0 / lookups : 0.0, (unsigned)st.entries,
+           (unsigned)(st.bytes / 1024), (unsigned)(st.limit / 1024), (unsigned)st.evictions);
+
+    std::lock_guard<std::mutex> lock(dir_cache_mutex);
+    dir_cache_counters = {};
 }
 
 esp_err_t fs_copy_file(const char *src, const char *dst) {
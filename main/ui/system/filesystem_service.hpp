@@ -3,6 +3,8 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <sys/stat.h>
+#include <stddef.h>
+#include <time.h>
 #ifdef _WIN32
     #include <io.h>
     #include <direct.h>
@@ -42,12 +44,21 @@ typedef struct {
     bool is_hidden;
 } file_info_t;
 
+// 目录标识：打开目录时记录，目录缓存用它判断目录是否变化
+typedef struct {
+    uint64_t dev;
+    uint64_t ino;           // Windows上为0
+    int64_t mtime_ns;
+    bool valid;
+} fs_dir_stamp_t;
+
 // 目录遍历结构体
 typedef struct {
     DIR *dir_handle;
     char current_path[MAX_PATH_LEN];
     int file_count;
     int dir_count;
+    fs_dir_stamp_t stamp;   // 打开时目录的标识
 } dir_iterator_t;
 
 // 文件排序类型
@@ -74,7 +85,100 @@ esp_err_t fs_remove_directory(const char *path);
 esp_err_t fs_list_directory(const char *path, file_info_t **files, int *count, sort_type_t sort);
 void fs_free_file_list(file_info_t *files, int count);
 
-// 目录遍历器
+// 紧凑目录列表：结构数组，文件名连续存放在一块字符串区中，排序只移动索引
+// 每项约十几个字节加文件名长度，而file_info_t固定约780字节。
+// 类型优先取readdir的d_type，只有类型未知或请求了大小/时间时才对该项调用fstatat。
+typedef enum {
+    FS_LIST_SIZE        = 1 << 0,   // 读取普通文件的大小（需要fstatat）
+    FS_LIST_TIME        = 1 << 1,   // 读取修改时间（需要fstatat）
+    FS_LIST_SKIP_HIDDEN = 1 << 2,   // 不列出隐藏文件
+} fs_list_flags_t;
+
+#define FS_ENTRY_TYPE_MASK  0x03
+#define FS_ENTRY_HIDDEN     0x80
+
+typedef struct {
+    uint32_t count;
+    char path[MAX_PATH_LEN];        // 列出的目录
+    char *names;                    // 字符串区，文件名以'\0'结尾依次存放
+    uint32_t names_used;
+    uint32_t names_cap;
+    uint32_t *name_offset;          // [count] 文件名在字符串区中的偏移
+    uint8_t *type;                  // [count] file_type_t，隐藏文件另加FS_ENTRY_HIDDEN
+    uint64_t *size;                 // [count] 没有请求FS_LIST_SIZE时为NULL
+    time_t *mtime;                  // [count] 没有请求FS_LIST_TIME时为NULL
+    uint32_t *order;                // [count] 排序后的项索引
+    uint32_t cap;                   // 各数组的容量（项数）
+    uint32_t stat_calls;            // 实际调用fstatat的次数
+    fs_dir_stamp_t stamp;           // 开始读取时目录的标识
+} fs_dir_list_t;
+
+// 按大小/时间排序时自动加上对应的标志；先查目录缓存，读取后存入缓存；失败时list为空
+esp_err_t fs_list_directory_compact(const char *path, sort_type_t sort, uint32_t flags, fs_dir_list_t *list);
+// 分批读取：从已打开的遍历器向list追加最多max_count项（list需先清零），不排序。
+// 读满max_count返回ESP_OK，读到目录末尾返回ESP_ERR_NOT_FOUND（本次可能已追加了项）。
+// 之后要按大小/时间排序时flags需要带上FS_LIST_SIZE/FS_LIST_TIME。
+esp_err_t fs_read_next_batch(dir_iterator_t *iterator, uint32_t flags, fs_dir_list_t *list, uint32_t max_count);
+void fs_dir_list_sort(fs_dir_list_t *list, sort_type_t sort);
+// 把已按sort排好序的src追加到list并归并，list保持有序
+esp_err_t fs_dir_list_merge(fs_dir_list_t *list, const fs_dir_list_t *src, sort_type_t sort);
+void fs_dir_list_free(fs_dir_list_t *list);
+// 列表占用的堆内存（字节）
+size_t fs_dir_list_memory(const fs_dir_list_t *list);
+// 第i项（排序后）的完整路径
+esp_err_t fs_dir_list_full_path(const fs_dir_list_t *list, uint32_t i, char *result_path, size_t result_size);
+
+// 目录列表缓存：按路径、排序方式和标志保存完整的列表，命中前比较目录的设备号/inode/修改时间，
+// 目录变化过的缓存项丢弃。按最近使用淘汰，总内存不超过上限，超过上限的单个列表不缓存。
+// 注意FAT文件系统上目录的修改时间不随目录内容变化，需要时用fs_dir_cache_invalidate强制重新读取。
+#ifndef FS_DIR_CACHE_DEFAULT_LIMIT
+#define FS_DIR_CACHE_DEFAULT_LIMIT  (256 * 1024)
+#endif
+#define FS_DIR_CACHE_MAX_ENTRIES    16
+
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;            // 包括stale
+    uint32_t stale;             // 找到了但目录已变化
+    uint32_t evictions;         // 为满足内存上限淘汰的项
+    uint32_t entries;
+    size_t bytes;
+    size_t limit;
+} fs_dir_cache_stats_t;
+
+// 命中时把缓存的列表复制到list（已排序）并返回ESP_OK，否则返回ESP_ERR_NOT_FOUND
+esp_err_t fs_dir_cache_lookup(const char *path, sort_type_t sort, uint32_t flags, fs_dir_list_t *list);
+// 把path的完整列表的副本存为缓存项；list->path与path不同或list->stamp无效（目录无法stat）时不保存
+esp_err_t fs_dir_cache_store(const char *path, const fs_dir_list_t *list, sort_type_t sort, uint32_t flags);
+// 丢弃path的缓存项，path为NULL时清空
+void fs_dir_cache_invalidate(const char *path);
+// 设置内存上限（字节），0为禁用缓存
+void fs_dir_cache_set_limit(size_t bytes);
+void fs_dir_cache_get_stats(fs_dir_cache_stats_t *stats);
+// 打印命中率和占用，然后清零计数
+void fs_dir_cache_log_stats(void);
+
+// 以下访问函数的i都是排序后的位置
+static inline uint32_t fs_dir_list_index(const fs_dir_list_t *list, uint32_t i) {
+    return list->order[i];
+}
+static inline const char *fs_dir_list_name(const fs_dir_list_t *list, uint32_t i) {
+    return list->names + list->name_offset[list->order[i]];
+}
+static inline file_type_t fs_dir_list_type(const fs_dir_list_t *list, uint32_t i) {
+    return (file_type_t)(list->type[list->order[i]] & FS_ENTRY_TYPE_MASK);
+}
+static inline bool fs_dir_list_is_hidden(const fs_dir_list_t *list, uint32_t i) {
+    return (list->type[list->order[i]] & FS_ENTRY_HIDDEN) != 0;
+}
+static inline uint64_t fs_dir_list_size(const fs_dir_list_t *list, uint32_t i) {
+    return list->size ? list->size[list->order[i]] : 0;
+}
+static inline time_t fs_dir_list_mtime(const fs_dir_list_t *list, uint32_t i) {
+    return list->mtime ? list->mtime[list->order[i]] : 0;
+}
+
+// 目录遍历器：逐项读取，内存占用与目录大小无关；读完时fs_read_next_file返回ESP_ERR_NOT_FOUND
 esp_err_t fs_open_directory(const char *path, dir_iterator_t *iterator);
 esp_err_t fs_read_next_file(dir_iterator_t *iterator, file_info_t *file_info);
 void fs_close_directory(dir_iterator_t *iterator);
@@ -1,4 +1,6 @@
 #include "mpu6050_service.h"
+#include "service_lock.h"
+#include "trace.h"
 #include <cstdlib>
 #include <ctime>
 #include <cmath>
@@ -8,6 +10,7 @@ static mpu6050_status_t current_status = {false, false, 0, 0};
 static mpu6050_data_t current_data = {0};
 
 esp_err_t mpu6050_service_init(void) {
+    SERVICE_LOCK();
     current_status.is_initialized = true;
     current_status.is_connected = true;
     current_status.error_count = 0;
@@ -18,12 +21,14 @@ esp_err_t mpu6050_service_init(void) {
 }
 
 void mpu6050_service_deinit(void) {
+    SERVICE_LOCK();
     current_status.is_initialized = false;
     current_status.is_connected = false;
     data_callback = nullptr;
 }
 
 esp_err_t mpu6050_read_data(mpu6050_data_t* data) {
+    SERVICE_LOCK();
     if (!current_status.is_initialized || !data) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -69,22 +74,27 @@ esp_err_t mpu6050_read_data(mpu6050_data_t* data) {
 }
 
 mpu6050_data_t mpu6050_get_last_data(void) {
+    SERVICE_LOCK();
     return current_data;
 }
 
 mpu6050_status_t mpu6050_get_status(void) {
+    SERVICE_LOCK();
     return current_status;
 }
 
 void mpu6050_set_data_callback(mpu6050_data_callback_t callback) {
+    SERVICE_LOCK();
     data_callback = callback;
 }
 
 void mpu6050_remove_data_callback(void) {
+    SERVICE_LOCK();
     data_callback = nullptr;
 }
 
 esp_err_t mpu6050_start_continuous_read(uint32_t interval_ms) {
+    SERVICE_LOCK();
     if (!current_status.is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -94,14 +104,17 @@ esp_err_t mpu6050_start_continuous_read(uint32_t interval_ms) {
 }
 
 esp_err_t mpu6050_stop_continuous_read(void) {
+    SERVICE_LOCK();
     return ESP_OK;
 }
 
 bool mpu6050_is_available(void) {
+    SERVICE_LOCK();
     return current_status.is_initialized && current_status.is_connected;
 }
 
 void mpu6050_update_data(void) {
+    SERVICE_LOCK();
     if (!current_status.is_initialized) return;
 
     mpu6050_data_t data;
@@ -111,18 +124,27 @@ void mpu6050_update_data(void) {
 }
 
 esp_err_t mpu6050_service_start(uint32_t interval_ms) {
+    SERVICE_LOCK();
     // Mock implementation - just mark as started
     current_status.is_initialized = true;
     current_status.is_connected = true;
     return ESP_OK;
 }
 
+void mpu6050_service_stop(void) {
+    SERVICE_LOCK();
+    // Mock implementation
+    mpu6050_stop_continuous_read();
+}
+
 esp_err_t mpu6050_service_calibrate(void) {
+    SERVICE_LOCK();
     // Mock implementation
     return ESP_OK;
 }
 
 esp_err_t mpu6050_service_reset(void) {
+    SERVICE_LOCK();
     // Mock implementation
     current_status.error_count = 0;
     return ESP_OK;
@@ -130,19 +152,24 @@ esp_err_t mpu6050_service_reset(void) {
 
 // 添加缺失的函数实现
 esp_err_t mpu6050_service_register_callback(mpu6050_data_callback_t callback) {
+    SERVICE_LOCK();
     data_callback = callback;
     return ESP_OK;
 }
 
 void mpu6050_service_unregister_callback(void) {
+    SERVICE_LOCK();
     data_callback = nullptr;
 }
 
 esp_err_t mpu6050_service_get_data(mpu6050_data_t* data) {
+    SERVICE_LOCK();
+    TRACE_FUNC();
     return mpu6050_read_data(data);
 }
 
 esp_err_t mpu6050_service_get_status(mpu6050_status_t* status) {
+    SERVICE_LOCK();
     if (!status) return ESP_ERR_INVALID_ARG;
     *status = current_status;
     return ESP_OK;
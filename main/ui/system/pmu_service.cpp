@@ -1,4 +1,6 @@
 #include "pmu_service.h"
+#include "service_lock.h"
+#include "trace.h"
 #include <cstdlib>
 #include <ctime>
 #include <algorithm>
@@ -104,6 +106,7 @@ static void update_mock_data() {
 }
 
 esp_err_t pmu_service_init(void) {
+    SERVICE_LOCK();
     if (pmu_initialized) {
         return ESP_OK;
     }
@@ -119,6 +122,7 @@ esp_err_t pmu_service_init(void) {
 }
 
 esp_err_t pmu_service_start(uint32_t interval_ms) {
+    SERVICE_LOCK();
     if (!pmu_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -133,22 +137,27 @@ esp_err_t pmu_service_start(uint32_t interval_ms) {
 }
 
 esp_err_t pmu_service_stop(void) {
+    SERVICE_LOCK();
     pmu_running = false;
     printf("PMU Service: Stopped\n");
     return ESP_OK;
 }
 
 esp_err_t pmu_service_register_data_callback(pmu_data_callback_t callback) {
+    SERVICE_LOCK();
     data_callback = callback;
     return ESP_OK;
 }
 
 esp_err_t pmu_service_register_event_callback(pmu_event_callback_t callback) {
+    SERVICE_LOCK();
     event_callback = callback;
     return ESP_OK;
 }
 
 esp_err_t pmu_service_get_data(pmu_data_t *data) {
+    SERVICE_LOCK();
+    TRACE_FUNC();
     if (!pmu_initialized || !data) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -168,10 +177,12 @@ esp_err_t pmu_service_get_data(pmu_data_t *data) {
 }
 
 pmu_status_t pmu_service_get_status(void) {
+    SERVICE_LOCK();
     return current_pmu_status;
 }
 
 esp_err_t pmu_service_set_charge_current(uint16_t current_ma) {
+    SERVICE_LOCK();
     if (!pmu_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -182,6 +193,7 @@ esp_err_t pmu_service_set_charge_current(uint16_t current_ma) {
 }
 
 esp_err_t pmu_service_set_charge_voltage(uint16_t voltage_mv) {
+    SERVICE_LOCK();
     if (!pmu_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -192,6 +204,7 @@ esp_err_t pmu_service_set_charge_voltage(uint16_t voltage_mv) {
 }
 
 esp_err_t pmu_service_set_power_channel(const char *channel, bool enable) {
+    SERVICE_LOCK();
     if (!pmu_initialized || !channel) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -222,6 +235,7 @@ esp_err_t pmu_service_set_power_channel(const char *channel, bool enable) {
 }
 
 esp_err_t pmu_service_reset(void) {
+    SERVICE_LOCK();
     if (!pmu_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -234,21 +248,25 @@ esp_err_t pmu_service_reset(void) {
 
 // 辅助函数：检查服务是否可用
 bool pmu_service_is_available(void) {
+    SERVICE_LOCK();
     return pmu_initialized && (current_pmu_status == PMU_STATUS_CONNECTED);
 }
 
 // 辅助函数：检查USB是否连接
 bool pmu_service_is_usb_connected(void) {
+    SERVICE_LOCK();
     return current_pmu_data.vbus_present;
 }
 
 // 辅助函数：检查电池是否在充电
 bool pmu_service_is_battery_charging(void) {
+    SERVICE_LOCK();
     return (current_pmu_data.battery_status == BATTERY_STATUS_CHARGING);
 }
 
 // 辅助函数：获取电池电量百分比
 int pmu_service_get_battery_percentage(void) {
+    SERVICE_LOCK();
     if (!pmu_initialized) {
         return -1;
     }
@@ -257,6 +275,7 @@ int pmu_service_get_battery_percentage(void) {
 
 // 辅助函数：获取电池电压（伏特）
 float pmu_service_get_battery_voltage(void) {
+    SERVICE_LOCK();
     if (!pmu_initialized) {
         return 0.0f;
     }
@@ -1,4 +1,6 @@
 #include "qmc5883l_service.h"
+#include "service_lock.h"
+#include "trace.h"
 #include <cmath>
 #include <cstdlib>
 #include <ctime>
@@ -12,6 +14,7 @@ static qmc5883l_status_t current_status = {false, false, 0, 0};
 static qmc5883l_service_data_t current_data = {0};
 
 esp_err_t qmc5883l_service_init(void) {
+    SERVICE_LOCK();
     current_status.is_initialized = true;
     current_status.is_connected = true;
     current_status.error_count = 0;
@@ -22,12 +25,14 @@ esp_err_t qmc5883l_service_init(void) {
 }
 
 void qmc5883l_service_deinit(void) {
+    SERVICE_LOCK();
     current_status.is_initialized = false;
     current_status.is_connected = false;
     data_callback = nullptr;
 }
 
 esp_err_t qmc5883l_service_read_data(qmc5883l_service_data_t* data) {
+    SERVICE_LOCK();
     if (!current_status.is_initialized || !data) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -63,22 +68,27 @@ esp_err_t qmc5883l_service_read_data(qmc5883l_service_data_t* data) {
 }
 
 qmc5883l_service_data_t qmc5883l_service_get_last_data(void) {
+    SERVICE_LOCK();
     return current_data;
 }
 
 qmc5883l_status_t qmc5883l_service_get_status(void) {
+    SERVICE_LOCK();
     return current_status;
 }
 
 void qmc5883l_service_set_data_callback(qmc5883l_data_callback_t callback) {
+    SERVICE_LOCK();
     data_callback = callback;
 }
 
 void qmc5883l_service_remove_data_callback(void) {
+    SERVICE_LOCK();
     data_callback = nullptr;
 }
 
 esp_err_t qmc5883l_service_start_continuous_read(uint32_t interval_ms) {
+    SERVICE_LOCK();
     if (!current_status.is_initialized) {
         return ESP_ERR_INVALID_STATE;
     }
@@ -88,14 +98,17 @@ esp_err_t qmc5883l_service_start_continuous_read(uint32_t interval_ms) {
 }
 
 esp_err_t qmc5883l_service_stop_continuous_read(void) {
+    SERVICE_LOCK();
     return ESP_OK;
 }
 
 bool qmc5883l_service_is_available(void) {
+    SERVICE_LOCK();
     return current_status.is_initialized && current_status.is_connected;
 }
 
 void qmc5883l_service_update_data(void) {
+    SERVICE_LOCK();
     if (!current_status.is_initialized) return;
 
     qmc5883l_service_data_t data;
@@ -105,6 +118,7 @@ void qmc5883l_service_update_data(void) {
 }
 
 float qmc5883l_service_get_heading(void) {
+    SERVICE_LOCK();
     if (!current_status.is_initialized) {
         return 0.0f;
     }
@@ -119,34 +133,47 @@ float qmc5883l_service_get_heading(void) {
 
 // 添加缺失的函数实现
 esp_err_t qmc5883l_service_start(uint32_t update_interval_ms) {
+    SERVICE_LOCK();
     return qmc5883l_service_start_continuous_read(update_interval_ms);
 }
 
+void qmc5883l_service_stop(void) {
+    SERVICE_LOCK();
+    qmc5883l_service_stop_continuous_read();
+}
+
 esp_err_t qmc5883l_service_get_data(qmc5883l_service_data_t* data) {
+    SERVICE_LOCK();
+    TRACE_FUNC();
     return qmc5883l_service_read_data(data);
 }
 
 esp_err_t qmc5883l_service_get_status(qmc5883l_status_t* status) {
+    SERVICE_LOCK();
     if (!status) return ESP_ERR_INVALID_ARG;
     *status = current_status;
     return ESP_OK;
 }
 
 esp_err_t qmc5883l_service_register_callback(qmc5883l_data_callback_t callback) {
+    SERVICE_LOCK();
     data_callback = callback;
     return ESP_OK;
 }
 
 void qmc5883l_service_unregister_callback(void) {
+    SERVICE_LOCK();
     data_callback = nullptr;
 }
 
 esp_err_t qmc5883l_service_calibrate(void) {
+    SERVICE_LOCK();
     // 模拟校准过程
     return ESP_OK;
 }
 
 esp_err_t qmc5883l_service_reset(void) {
+    SERVICE_LOCK();
     // 模拟复位过程
     current_status.error_count = 0;
     return ESP_OK;
@@ -0,0 +1,23 @@
+/**
+ * @file service_lock.h
+ * @brief 服务状态锁
+ *
+ * 服务的数据回调会直接更新LVGL控件，因此服务与LVGL共用同一把递归锁（lv_lock）：
+ * - LV_OS_NONE下为空操作
+ * - LV_OS_PTHREAD（多线程渲染配置）下，其他线程调用服务接口时与lv_timer_handler互斥
+ * 在LVGL定时器回调中调用服务接口时锁已被持有，递归加锁不会死锁。
+ */
+
+#pragma once
+
+#include "lvgl/lvgl.h"
+
+class ServiceLock {
+public:
+    ServiceLock() { lv_lock(); }
+    ~ServiceLock() { lv_unlock(); }
+    ServiceLock(const ServiceLock &) = delete;
+    ServiceLock &operator=(const ServiceLock &) = delete;
+};
+
+#define SERVICE_LOCK() ServiceLock service_lock_guard
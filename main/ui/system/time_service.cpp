@@ -1,4 +1,5 @@
 #include "time_service.h"
+#include "service_lock.h"
 #include <ctime>
 #include <cstring>
 #include <chrono>
@@ -11,16 +12,19 @@ static bool time_synced = false;
 static auto start_time = std::chrono::steady_clock::now();
 
 void init() {
+    SERVICE_LOCK();
     service_initialized = true;
     time_synced = true; // 模拟时间已同步
 }
 
 void deinit() {
+    SERVICE_LOCK();
     service_initialized = false;
     time_callback = nullptr;
 }
 
 TimeInfo get_time_info() {
+    SERVICE_LOCK();
     TimeInfo info = {};
 
     if (!service_initialized) {
@@ -57,18 +61,22 @@ TimeInfo get_time_info() {
 }
 
 void set_time_update_callback(TimeUpdateCallback callback) {
+    SERVICE_LOCK();
     time_callback = callback;
 }
 
 void remove_time_update_callback() {
+    SERVICE_LOCK();
     time_callback = nullptr;
 }
 
 bool is_time_synced() {
+    SERVICE_LOCK();
     return time_synced;
 }
 
 const char* format_running_time(unsigned long millis) {
+    SERVICE_LOCK();
     static char buffer[32];
     unsigned long seconds = millis / 1000;
     unsigned long hours = seconds / 3600;
@@ -80,27 +88,33 @@ const char* format_running_time(unsigned long millis) {
 }
 
 void start_sntp_sync() {
+    SERVICE_LOCK();
     // 模拟SNTP同步
     time_synced = true;
 }
 
 void stop_sntp_sync() {
+    SERVICE_LOCK();
     // 停止SNTP同步
 }
 
 bool is_sntp_syncing() {
+    SERVICE_LOCK();
     return false; // 模拟非同步状态
 }
 
 bool is_rtc_available() {
+    SERVICE_LOCK();
     return true; // 模拟RTC可用
 }
 
 bool sync_rtc_from_system() {
+    SERVICE_LOCK();
     return true; // 模拟同步成功
 }
 
 bool get_rtc_time(struct tm* rtc_time) {
+    SERVICE_LOCK();
     if (!rtc_time) return false;
 
     auto now = std::time(nullptr);
@@ -110,6 +124,7 @@ bool get_rtc_time(struct tm* rtc_time) {
 
 // 辅助函数：更新时间信息（供UI调用）
 void update_time_info() {
+    SERVICE_LOCK();
     if (!service_initialized || !time_callback) return;
 
     TimeInfo info = get_time_info();
@@ -0,0 +1,128 @@
+// trace.cpp
+// 时间线追踪实现
+#include "trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+struct TraceEvent {
+    const char *name;
+    uint64_t ts_us;
+    uint32_t tid;
+    char phase;         // 'B' 开始, 'E' 结束, 'i' 瞬时
+};
+
+TraceEvent *events = nullptr;
+size_t capacity = 0;
+std::atomic<size_t> count{0};
+std::atomic<uint32_t> dropped{0};
+std::atomic<bool> enabled{false};
+std::atomic<uint32_t> next_tid{1};
+
+const auto time_origin = std::chrono::steady_clock::now();
+
+uint32_t thread_id() {
+    thread_local uint32_t tid = next_tid.fetch_add(1);
+    return tid;
+}
+
+// 各线程通过原子计数器占用不同的槽位，互不干扰
+void record(const char *name, char phase) {
+    if(!enabled.load(std::memory_order_relaxed)) return;
+    size_t idx = count.fetch_add(1, std::memory_order_relaxed);
+    if(idx >= capacity) {
+        count.store(capacity, std::memory_order_relaxed);
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceEvent &ev = events[idx];
+    ev.name = name ? name : "?";
+    ev.ts_us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - time_origin).count();
+    ev.tid = thread_id();
+    ev.phase = phase;
+}
+
+// 名称来自函数名和字符串常量，只需转义引号和反斜杠
+void write_name(FILE *f, const char *name) {
+    for(const char *p = name; *p; p++) {
+        if(*p == '"' || *p == '\\') fputc('\\', f);
+        fputc(*p, f);
+    }
+}
+
+} // namespace
+
+
+extern "C" bool trace_start(size_t max_events) {
+    enabled.store(false);
+    if(max_events != capacity) {
+        free(events);
+        events = (TraceEvent *)malloc(max_events * sizeof(TraceEvent));
+        capacity = events ? max_events : 0;
+    }
+    count.store(0);
+    dropped.store(0);
+    if(!events) return false;
+    enabled.store(true);
+    return true;
+}
+
+
+extern "C" void trace_stop(void) {
+    enabled.store(false);
+}
+
+
+extern "C" bool trace_enabled(void) {
+    return enabled.load(std::memory_order_relaxed);
+}
+
+
+extern "C" void trace_begin(const char *name) {
+    record(name, 'B');
+}
+
+
+extern "C" void trace_end(const char *name) {
+    record(name, 'E');
+}
+
+
+extern "C" void trace_instant(const char *name) {
+    record(name, 'i');
+}
+
+
+// 导出前先停止记录，避免其他线程写入未完成的事件
+extern "C" int32_t trace_write_json(const char *path) {
+    FILE *f = fopen(path, "w");
+    if(!f) return -1;
+
+    bool was_enabled = enabled.exchange(false);
+    size_t n = count.load();
+    if(n > capacity) n = capacity;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for(size_t i = 0; i < n; i++) {
+        const TraceEvent &ev = events[i];
+        fprintf(f, "{\"name\":\"");
+        write_name(f, ev.name);
+        fprintf(f, "\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":1,\"tid\":%u%s}%s\n",
+                ev.phase, (unsigned long long)ev.ts_us, (unsigned)ev.tid,
+                ev.phase == 'i' ? ",\"s\":\"p\"" : "", i + 1 < n ? "," : "");
+    }
+    fprintf(f, "]}\n");
+    fclose(f);
+
+    enabled.store(was_enabled);
+    return (int32_t)n;
+}
+
+
+extern "C" uint32_t trace_dropped(void) {
+    return dropped.load();
+}
@@ -0,0 +1,118 @@
+/**
+ * @file trace.h
+ * @brief 时间线追踪：记录LVGL性能分析钩子和应用代码的耗时区间，导出Chrome trace JSON
+ *
+ * - LVGL通过lv_conf.h中的LV_PROFILER_BEGIN/END宏调用trace_begin/trace_end
+ * - 应用代码使用TRACE_SCOPE(name)记录作用域耗时
+ * - 导出文件可在chrome://tracing或https://ui.perfetto.dev中打开
+ *
+ * 事件写入预分配的缓冲区，多线程写入无锁；缓冲区满后丢弃新事件。
+ * 本头文件会被LVGL的C代码包含，不能依赖lvgl.h。
+ *
+ * 只在CMake选项LV_TRACE打开时编译（定义LV_TRACE=1并启用LV_USE_PROFILER），
+ * 否则下面的函数为空实现，TRACE_SCOPE不产生代码，trace_start返回false。
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef LV_TRACE
+#define LV_TRACE 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if LV_TRACE
+
+/**
+ * @brief 分配事件缓冲区并开始记录
+ * @param max_events 最多记录的事件数（每个区间占两个事件）
+ * @return true 成功
+ */
+bool trace_start(size_t max_events);
+
+/**
+ * @brief 停止记录，已记录的事件保留到下次trace_start
+ */
+void trace_stop(void);
+
+/**
+ * @brief 是否正在记录
+ */
+bool trace_enabled(void);
+
+/**
+ * @brief 区间开始
+ * @param name 区间名称，必须是静态字符串（只保存指针）
+ */
+void trace_begin(const char *name);
+
+/**
+ * @brief 区间结束，与同一线程最近的trace_begin配对
+ */
+void trace_end(const char *name);
+
+/**
+ * @brief 瞬时事件，例如帧边界或页面跳转
+ */
+void trace_instant(const char *name);
+
+/**
+ * @brief 导出为Chrome trace JSON
+ * @param path 输出文件路径
+ * @return 写入的事件数，打开文件失败返回-1
+ */
+int32_t trace_write_json(const char *path);
+
+/**
+ * @brief 因缓冲区满而丢弃的事件数
+ */
+uint32_t trace_dropped(void);
+
+#else
+
+static inline bool trace_start(size_t max_events) { (void)max_events; return false; }
+static inline void trace_stop(void) {}
+static inline bool trace_enabled(void) { return false; }
+static inline void trace_begin(const char *name) { (void)name; }
+static inline void trace_end(const char *name) { (void)name; }
+static inline void trace_instant(const char *name) { (void)name; }
+static inline int32_t trace_write_json(const char *path) { (void)path; return -1; }
+static inline uint32_t trace_dropped(void) { return 0; }
+
+#endif
+
+#ifdef __cplusplus
+}
+
+#if LV_TRACE
+
+/**
+ * @brief 作用域区间，析构时结束
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char *name) : name(name) { trace_begin(name); }
+    ~TraceScope() { trace_end(name); }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_FUNC() TRACE_SCOPE(__func__)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_FUNC() ((void)0)
+#endif
+
+#endif
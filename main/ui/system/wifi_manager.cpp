@@ -1,4 +1,5 @@
 #include "wifi_manager.h"
+#include "service_lock.h"
 #include <cstring>
 #include <cstdlib>
 #include <ctime>
@@ -22,6 +23,7 @@ static wifi_manager_ap_info_t mock_scan_results[] = {
 };
 
 esp_err_t wifi_manager_init(void) {
+    SERVICE_LOCK();
     if (initialized) {
         return ESP_OK;
     }
@@ -34,18 +36,22 @@ esp_err_t wifi_manager_init(void) {
 }
 
 wifi_manager_status_t wifi_manager_get_status(void) {
+    SERVICE_LOCK();
     return current_status;
 }
 
 void wifi_manager_register_status_cb(wifi_manager_status_cb_t cb) {
+    SERVICE_LOCK();
     status_callback = cb;
 }
 
 void wifi_manager_register_sntp_cb(wifi_manager_sntp_cb_t cb) {
+    SERVICE_LOCK();
     sntp_callback = cb;
 }
 
 esp_err_t wifi_manager_connect_with_config(const wifi_manager_config_t* config) {
+    SERVICE_LOCK();
     if (!initialized || !config) {
         return ESP_FAIL;
     }
@@ -88,6 +94,7 @@ esp_err_t wifi_manager_connect_with_config(const wifi_manager_config_t* config)
 }
 
 esp_err_t wifi_manager_connect_to_ap(const char* ssid, const char* password) {
+    SERVICE_LOCK();
     if (!ssid) {
         return ESP_FAIL;
     }
@@ -104,6 +111,7 @@ esp_err_t wifi_manager_connect_to_ap(const char* ssid, const char* password) {
 }
 
 void wifi_manager_disconnect(void) {
+    SERVICE_LOCK();
     current_status = WIFI_MANAGER_DISCONNECTED;
     memset(&current_config, 0, sizeof(current_config));
 
@@ -113,12 +121,14 @@ void wifi_manager_disconnect(void) {
 }
 
 bool wifi_manager_is_connected(void) {
+    SERVICE_LOCK();
     return (current_status == WIFI_MANAGER_CONNECTED ||
             current_status == WIFI_MANAGER_TIME_SYNCING ||
             current_status == WIFI_MANAGER_TIME_SYNCED);
 }
 
 esp_err_t wifi_manager_get_current_ssid(char* ssid_buf, size_t buf_len) {
+    SERVICE_LOCK();
     if (!ssid_buf || buf_len == 0) {
         return ESP_FAIL;
     }
@@ -134,6 +144,7 @@ esp_err_t wifi_manager_get_current_ssid(char* ssid_buf, size_t buf_len) {
 }
 
 esp_err_t wifi_manager_get_current_ip(char* ip_buf, size_t buf_len) {
+    SERVICE_LOCK();
     if (!ip_buf || buf_len == 0) {
         return ESP_FAIL;
     }
@@ -149,6 +160,7 @@ esp_err_t wifi_manager_get_current_ip(char* ip_buf, size_t buf_len) {
 }
 
 int8_t wifi_manager_get_rssi(void) {
+    SERVICE_LOCK();
     if (!wifi_manager_is_connected()) {
         return 0;
     }
@@ -158,6 +170,7 @@ int8_t wifi_manager_get_rssi(void) {
 }
 
 esp_err_t wifi_manager_start_scan(bool block) {
+    SERVICE_LOCK();
     if (!initialized) {
         return ESP_FAIL;
     }
@@ -169,6 +182,7 @@ esp_err_t wifi_manager_start_scan(bool block) {
 esp_err_t wifi_manager_get_scan_results(wifi_manager_ap_info_t* ap_list,
                                        uint16_t max_count,
                                        uint16_t* actual_count) {
+    SERVICE_LOCK();
     if (!ap_list || max_count == 0 || !actual_count) {
         return ESP_ERR_INVALID_ARG;
     }
@@ -187,6 +201,7 @@ esp_err_t wifi_manager_get_scan_results(wifi_manager_ap_info_t* ap_list,
 }
 
 esp_err_t wifi_manager_save_config(const wifi_manager_config_t* config) {
+    SERVICE_LOCK();
     if (!config) {
         return ESP_FAIL;
     }
@@ -196,6 +211,7 @@ esp_err_t wifi_manager_save_config(const wifi_manager_config_t* config) {
 }
 
 esp_err_t wifi_manager_load_config(wifi_manager_config_t* config) {
+    SERVICE_LOCK();
     if (!config) {
         return ESP_FAIL;
     }
@@ -210,12 +226,14 @@ esp_err_t wifi_manager_load_config(wifi_manager_config_t* config) {
 }
 
 void wifi_manager_clear_config(void) {
+    SERVICE_LOCK();
     // 模拟清除NVS中的配置
     memset(&current_config, 0, sizeof(current_config));
 }
 
 // 添加缺失的函数实现
 esp_err_t wifi_manager_get_connected_ssid(char* ssid_buf, size_t buf_len) {
+    SERVICE_LOCK();
     if (!ssid_buf || buf_len == 0) {
         return ESP_ERR_INVALID_ARG;
     }
@@ -233,16 +251,19 @@ esp_err_t wifi_manager_get_connected_ssid(char* ssid_buf, size_t buf_len) {
 }
 
 esp_err_t wifi_manager_register_status_callback(wifi_manager_status_cb_t callback) {
+    SERVICE_LOCK();
     status_callback = callback;
     return ESP_OK;
 }
 
 esp_err_t wifi_manager_unregister_status_callback(void) {
+    SERVICE_LOCK();
     status_callback = nullptr;
     return ESP_OK;
 }
 esp_err_t wifi_manager_enable(void)
 {
+    SERVICE_LOCK();
     ESP_LOGI(TAG, "Enabling WiFi...");
     esp_err_t ret = ESP_OK;
     return ret;
@@ -250,6 +271,7 @@ esp_err_t wifi_manager_enable(void)
 
 esp_err_t wifi_manager_disable(void)
 {
+    SERVICE_LOCK();
     ESP_LOGI(TAG, "Disabling WiFi...");
     esp_err_t ret = ESP_OK;
     return ret;
@@ -257,6 +279,7 @@ esp_err_t wifi_manager_disable(void)
 
 bool wifi_manager_is_enabled(void)
 {
+    SERVICE_LOCK();
     bool enabled;
     //随机返回WiFi是否启用
     enabled = (rand() % 2) == 0; // 50%概率启用
@@ -0,0 +1,33 @@
+#!/usr/bin/env python3
+# 多线程渲染扩展性测试：分别以 1..N 个软件绘制单元构建 render_bench 并运行，输出吞吐量和加速比
+# 用法: python3 render_scaling.py [最大绘制单元数] [render_bench 参数...]
+# 例如: python3 render_scaling.py 8 --width 480 --height 800 --frames 300
+import os
+import subprocess
+import sys
+
+root = os.path.dirname(os.path.abspath(__file__))
+max_units = int(sys.argv[1]) if len(sys.argv) > 1 else os.cpu_count()
+bench_args = sys.argv[2:]
+jobs = str(os.cpu_count())
+
+results = []
+for units in range(1, max_units + 1):
+    build_dir = os.path.join(root, 'build_mt', str(units))
+    subprocess.run(['cmake', '-S', root, '-B', build_dir, '-DCMAKE_BUILD_TYPE=Release',
+                    '-DLV_MT_RENDER=ON', '-DLV_MT_RENDER_UNITS=' + str(units)],
+                   check=True, stdout=subprocess.DEVNULL)
+    subprocess.run(['cmake', '--build', build_dir, '--target', 'render_bench', '-j', jobs],
+                   check=True, stdout=subprocess.DEVNULL)
+
+    # 所有构建共用 bin/ 输出目录，构建后立即运行
+    out = subprocess.run([os.path.join(root, 'bin', 'render_bench')] + bench_args,
+                         check=True, capture_output=True, text=True).stdout
+    total = [line for line in out.splitlines() if line.startswith('total,')][0].split(',')
+    results.append((units, float(total[4]), float(total[5]), float(total[6])))
+    print(out, end='')
+
+base_fps = results[0][2]
+print('\nunits  frame_us      fps  Mpx/s  speedup')
+for units, frame_us, fps, mpx in results:
+    print(f'{units:5d}  {frame_us:8.1f} {fps:8.1f} {mpx:6.2f}  {fps / base_fps:6.2f}x')